@@ -8,6 +8,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
+#include "objparser.h"
 
 using std::string;
 
@@ -134,7 +135,7 @@ void render() {
 						  GL_FALSE,
 						  sizeof(Vertex),
 						  (void*)offsetof(Vertex,color));
-    glDrawArrays(GL_TRIANGLES, 0, num*4);
+    glDrawArrays(GL_TRIANGLES, 0, num*3);
     glDisableVertexAttribArray(loc_position);
     glDisableVertexAttribArray(loc_color);
 /*
@@ -316,7 +317,7 @@ bool initialize() {
 
     glGenBuffers(1, &vbo_geometry);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_geometry);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(geometry)*x*4, geometry, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex)*x, geometry, GL_STATIC_DRAW);
 
     //glGenBuffers(1, &vbo_geometry2);
     //glBindBuffer(GL_ARRAY_BUFFER, vbo_geometry2);
@@ -371,93 +372,28 @@ float getDT() {
 }
 
 std::vector<Vertex> modelLoader(string fName) {
-	std::fstream fin;
-	string line;
-	float value[2];
-	int temp[4];
+	ObjMesh mesh;
 	Vertex vecTemp;
 	std::vector<Vertex> retVertex;
-	std::vector<Vertex> vertex1;
-	std::vector<int> point;
-	int z;
-	bool triangle = true;
-	fin.open(fName);
-	char garbage;
-	string gar;
-	
-	while(!fin.eof()) {
-		fin >> line;
-		if(line =="#") {
-			fin.ignore(128, '\n');
-		} 
-		else if(line == "o") {
-			fin >> line;
-		} 
-		else if( line == "v" ) {
-			for(int i = 0; i < 3; i++) {
-				fin >> value[0];
-				vecTemp.position[i] = value[0];
-				vecTemp.color[0] = 0.214f;
-				vecTemp.color[1] = 0.214f;
-				vecTemp.color[2] = 0.214f;
-			}
-			vertex1.push_back(vecTemp);
-		} 
-		else if(line == "f") {
-			while(!fin.eof()) {
-				fin >> z;
-				temp[0] = z;
-				garbage = fin.peek();
-				if(garbage == ' ') {
-					fin >> z;
-					temp[1] = z;
-					fin >> z;
-					temp[2] = z;
-					garbage = fin.peek();
-					if(garbage == ' ') {
-						fin >> z;
-						triangle = false;
-						temp[3] = z;
-					}
-					fin >> garbage;
-				}
-				else {
-					fin >> gar;
-					fin >> z;
-					temp[1] = z;
-					fin >> gar;
-					fin >> z;
-					temp[2] = z;
-					fin >> gar;
-					garbage = fin.peek();
-					if(garbage == ' ') {
-						fin >> z;
-						triangle = false;
-						temp[3] = z;
-						fin >> gar;
-					}
-					fin >> garbage;
-				}
-				if(garbage =='u') {
-					fin >> gar >> gar;
-					fin.get(garbage);
-					fin.get(garbage);
-				}
-				for(int i=0; i<3; i++) 
-					retVertex.push_back(vertex1[temp[i]-1]);
-
-				if(!triangle) {
-					retVertex.push_back(vertex1[temp[0]-1]);
-					retVertex.push_back(vertex1[temp[2]-1]);
-					retVertex.push_back(vertex1[temp[3]-1]);
-				}
-				triangle = true;
-				num++;
-				//std::cout << temp[0] << " " << temp[1] << " " << temp[2] << " " << temp[3] << std::endl;
-				//std::cin >> z;
-			}
-		}
+
+	// parse the whole file, large files are split across threads
+	if(!ObjParser::parse(fName, mesh)) {
+		std::cerr << "[F] UNABLE TO LOAD OBJECT FILE: " << fName << std::endl;
+		return retVertex;
 	}
-	fin.close();
+
+	vecTemp.color[0] = 0.214f;
+	vecTemp.color[1] = 0.214f;
+	vecTemp.color[2] = 0.214f;
+
+	// expand every triangle corner into a vertex
+	retVertex.reserve(mesh.indices.size());
+	for(const ObjIndex& corner : mesh.indices) {
+		for(int i = 0; i < 3; i++)
+			vecTemp.position[i] = mesh.positions[corner.position * 3 + i];
+		retVertex.push_back(vecTemp);
+	}
+
+	num = mesh.indices.size() / 3;
 	return retVertex;
 }
@@ -0,0 +1,95 @@
+// compares ObjParser against Assimp's OBJ importer on the same files
+// usage: ./objbench [runs] [file.obj ...]
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+
+// if using assimp version 2, load different headers
+#ifdef ASSIMP_2
+#include <assimp/assimp.hpp>
+#include <assimp/aiScene.h>
+#include <assimp/aiPostProcess.h>
+#else // assimp version 3
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#endif
+
+#include "objparser.h"
+
+// run a loader several times and return the median time in milliseconds
+double timeLoader(int runs, std::function<bool()> loader, bool& ok) {
+	std::vector<double> times;
+
+	ok = true;
+	for(int i = 0; i < runs; i++) {
+		auto t1 = std::chrono::high_resolution_clock::now();
+		ok = loader() && ok;
+		auto t2 = std::chrono::high_resolution_clock::now();
+		times.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+	}
+
+	std::sort(times.begin(), times.end());
+	return times[times.size() / 2];
+}
+
+int main(int argc, char **argv) {
+	int runs = 5;
+	std::vector<std::string> files;
+	bool faster = true;
+
+	if(argc > 1)
+		runs = std::max(1, std::atoi(argv[1]));
+	for(int i = 2; i < argc; i++)
+		files.push_back(argv[i]);
+
+	// default to the labyrinth boards
+	if(files.empty()) {
+		files.push_back("../../Assignment11/bin/board.obj");
+		files.push_back("../../Assignment11/bin/boardTop.obj");
+	}
+
+	std::cout << std::fixed << std::setprecision(2);
+
+	for(const std::string& file : files) {
+		ObjMesh mesh;
+		bool ok[4];
+		double times[4];
+
+		times[0] = timeLoader(runs, [&]() { return ObjParser::parse(file, mesh, 1); }, ok[0]);
+		times[1] = timeLoader(runs, [&]() { return ObjParser::parse(file, mesh); }, ok[1]);
+		times[2] = timeLoader(runs, [&]() {
+			Assimp::Importer importer;
+			return importer.ReadFile(file, aiProcess_Triangulate) != nullptr;
+		}, ok[2]);
+		times[3] = timeLoader(runs, [&]() {
+			Assimp::Importer importer;
+			return importer.ReadFile(file, aiProcessPreset_TargetRealtime_Fast) != nullptr;
+		}, ok[3]);
+
+		if(!ok[0] || !ok[1] || !ok[2] || !ok[3]) {
+			std::cerr << "[F] UNABLE TO LOAD " << file << std::endl;
+			return 1;
+		}
+
+		double best = std::min(times[0], times[1]);
+		faster = faster && best < times[2];
+
+		std::cout << file << " (" << mesh.positions.size() / 3 << " vertices, "
+		          << mesh.indices.size() / 3 << " triangles, median of " << runs << ")" << std::endl
+		          << "  ObjParser 1 thread:      " << std::setw(9) << times[0] << " ms" << std::endl
+		          << "  ObjParser " << std::setw(2) << std::thread::hardware_concurrency()
+		          << " threads:     " << std::setw(9) << times[1] << " ms" << std::endl
+		          << "  Assimp triangulate:      " << std::setw(9) << times[2] << " ms" << std::endl
+		          << "  Assimp realtime fast:    " << std::setw(9) << times[3] << " ms" << std::endl
+		          << "  speedup over Assimp:     " << std::setw(9) << times[2] / best << "x" << std::endl;
+	}
+
+	// fail when the parser loses so the benchmark can gate changes
+	return faster ? 0 : 1;
+}
@@ -0,0 +1,454 @@
+#include "objparser.h"
+
+#include <cstring>
+#include <algorithm>
+#include <functional>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+// flags marking corner indices that are relative to the chunk's first element
+const unsigned char RELATIVE_POSITION = 1;
+const unsigned char RELATIVE_TEXCOORD = 2;
+const unsigned char RELATIVE_NORMAL = 4;
+
+// material used by triangles before the first usemtl of a chunk
+const int INHERIT_MATERIAL = -2;
+
+// result of parsing one line aligned piece of the file
+struct Chunk {
+	ObjMesh mesh;
+	std::vector<unsigned char> relative;
+	int lastMaterial;
+	bool valid;
+};
+
+inline bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipSpace(const char *p, const char *end) {
+	while(p < end && isSpace(*p))
+		p++;
+	return p;
+}
+
+inline const char* skipLine(const char *p, const char *end) {
+	if(p >= end)
+		return end;
+	const char *newline = static_cast<const char*>(memchr(p, '\n', end - p));
+	return newline ? newline + 1 : end;
+}
+
+// locale independent float parser for the decimal forms OBJ exporters write
+const char* parseFloat(const char *p, const char *end, float& value) {
+	static const double powers[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	double mantissa = 0.0;
+	int exponent = 0;
+	bool negative = false;
+
+	p = skipSpace(p, end);
+	if(p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+
+	const char *digits = p;
+	while(p < end && *p >= '0' && *p <= '9')
+		mantissa = mantissa * 10.0 + (*p++ - '0');
+
+	if(p < end && *p == '.') {
+		p++;
+		while(p < end && *p >= '0' && *p <= '9') {
+			mantissa = mantissa * 10.0 + (*p++ - '0');
+			exponent--;
+		}
+	}
+
+	// no digits at all is not a number
+	if(p == digits || (p == digits + 1 && *digits == '.'))
+		return nullptr;
+
+	if(p < end && (*p == 'e' || *p == 'E')) {
+		const char *e = p + 1;
+		bool negativeExponent = false;
+		int value = 0;
+
+		if(e < end && (*e == '-' || *e == '+'))
+			negativeExponent = *e++ == '-';
+
+		if(e < end && *e >= '0' && *e <= '9') {
+			while(e < end && *e >= '0' && *e <= '9')
+				value = value * 10 + (*e++ - '0');
+			exponent += negativeExponent ? -value : value;
+			p = e;
+		}
+	}
+
+	// scale by the exponent in as few steps as possible
+	while(exponent > 22) {
+		mantissa *= 1e22;
+		exponent -= 22;
+	}
+	while(exponent < -22) {
+		mantissa /= 1e22;
+		exponent += 22;
+	}
+	mantissa = exponent >= 0 ? mantissa * powers[exponent] : mantissa / powers[-exponent];
+
+	value = float(negative ? -mantissa : mantissa);
+	return p;
+}
+
+const char* parseInt(const char *p, const char *end, int& value) {
+	bool negative = false;
+	const char *digits;
+
+	if(p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+
+	digits = p;
+	value = 0;
+	while(p < end && *p >= '0' && *p <= '9')
+		value = value * 10 + (*p++ - '0');
+
+	if(p == digits)
+		return nullptr;
+
+	if(negative)
+		value = -value;
+	return p;
+}
+
+// turn a 1 based or negative OBJ index into a chunk relative zero based one
+inline bool resolveIndex(int raw, int count, int& index, unsigned char& relative, unsigned char flag) {
+	if(raw > 0) {
+		index = raw - 1;
+		return true;
+	}
+
+	if(raw < 0) {
+		// negative indices count back from the last element read so far
+		index = count + raw;
+		relative |= flag;
+		return true;
+	}
+
+	return false;
+}
+
+// parse one face corner: v, v/vt, v//vn or v/vt/vn
+const char* parseCorner(const char *p, const char *end, const ObjMesh& mesh,
+                        ObjIndex& corner, unsigned char& relative) {
+	int raw;
+	relative = 0;
+	corner.texCoord = corner.normal = -1;
+
+	p = parseInt(p, end, raw);
+	if(!p || !resolveIndex(raw, mesh.positions.size() / 3, corner.position, relative, RELATIVE_POSITION))
+		return nullptr;
+
+	if(p < end && *p == '/') {
+		p++;
+		if(p < end && *p != '/') {
+			p = parseInt(p, end, raw);
+			if(!p || !resolveIndex(raw, mesh.texCoords.size() / 2, corner.texCoord, relative, RELATIVE_TEXCOORD))
+				return nullptr;
+		}
+
+		if(p < end && *p == '/') {
+			p++;
+			p = parseInt(p, end, raw);
+			if(!p || !resolveIndex(raw, mesh.normals.size() / 3, corner.normal, relative, RELATIVE_NORMAL))
+				return nullptr;
+		}
+	}
+
+	return p;
+}
+
+inline bool startsWith(const char *p, const char *end, const char *keyword, size_t length) {
+	return size_t(end - p) > length && memcmp(p, keyword, length) == 0 && isSpace(p[length]);
+}
+
+// parse every line in [begin, end), begin and end sit on line boundaries
+void parseChunk(const char *begin, const char *end, Chunk& chunk) {
+	ObjMesh& mesh = chunk.mesh;
+	std::vector<ObjIndex> face;
+	std::vector<unsigned char> faceRelative;
+	int material = INHERIT_MATERIAL;
+	const char *p = begin;
+
+	chunk.valid = true;
+	chunk.lastMaterial = material;
+
+	while(p < end) {
+		p = skipSpace(p, end);
+		const char *lineEnd = skipLine(p, end);
+
+		if(p < end && *p == 'v') {
+			float value;
+
+			// vertex position, extra w or color values are ignored
+			if(startsWith(p, lineEnd, "v", 1)) {
+				const char *q = p + 1;
+				for(int i = 0; i < 3 && q; i++) {
+					q = parseFloat(q, lineEnd, value);
+					mesh.positions.push_back(q ? value : 0.0f);
+				}
+			}
+
+			// texture coordinate, a missing v defaults to 0
+			else if(startsWith(p, lineEnd, "vt", 2)) {
+				const char *q = parseFloat(p + 2, lineEnd, value);
+				mesh.texCoords.push_back(q ? value : 0.0f);
+				q = q ? parseFloat(q, lineEnd, value) : nullptr;
+				mesh.texCoords.push_back(q ? value : 0.0f);
+			}
+
+			// normal
+			else if(startsWith(p, lineEnd, "vn", 2)) {
+				const char *q = p + 2;
+				for(int i = 0; i < 3 && q; i++) {
+					q = parseFloat(q, lineEnd, value);
+					mesh.normals.push_back(q ? value : 0.0f);
+				}
+			}
+		}
+
+		else if(startsWith(p, lineEnd, "f", 1)) {
+			const char *q = p + 1;
+			face.clear();
+			faceRelative.clear();
+
+			// read corners until the end of the line
+			while(true) {
+				q = skipSpace(q, lineEnd);
+				if(q >= lineEnd || *q == '\n' || *q == '#')
+					break;
+
+				ObjIndex corner;
+				unsigned char relative;
+				q = parseCorner(q, lineEnd, mesh, corner, relative);
+				if(!q) {
+					chunk.valid = false;
+					return;
+				}
+
+				face.push_back(corner);
+				faceRelative.push_back(relative);
+			}
+
+			// fan triangulate faces with more than 3 corners
+			for(size_t i = 2; i < face.size(); i++) {
+				size_t corners[3] = {0, i - 1, i};
+				for(size_t c : corners) {
+					mesh.indices.push_back(face[c]);
+					chunk.relative.push_back(faceRelative[c]);
+				}
+				mesh.materials.push_back(material);
+			}
+		}
+
+		else if(startsWith(p, lineEnd, "usemtl", 6)) {
+			const char *name = skipSpace(p + 6, lineEnd);
+			const char *nameEnd = lineEnd;
+			while(nameEnd > name && (isSpace(nameEnd[-1]) || nameEnd[-1] == '\n'))
+				nameEnd--;
+
+			// materials are numbered in order of first use within the chunk
+			std::string materialName(name, nameEnd);
+			material = -1;
+			for(size_t i = 0; i < mesh.materialNames.size(); i++)
+				if(mesh.materialNames[i] == materialName)
+					material = i;
+
+			if(material == -1) {
+				material = mesh.materialNames.size();
+				mesh.materialNames.push_back(materialName);
+			}
+		}
+
+		// comments, groups, objects, smoothing and mtllib are skipped
+		p = lineEnd;
+	}
+
+	chunk.lastMaterial = material;
+}
+
+// add chunk offsets to relative indices and copy a chunk into the result,
+// the chunk turns invalid if a negative index points before the first element
+void mergeChunk(Chunk& chunk, ObjMesh& mesh, size_t positionBase, size_t texCoordBase,
+                size_t normalBase, size_t indexBase, const std::vector<int>& materialMap, int inherited) {
+	const ObjMesh& part = chunk.mesh;
+
+	std::copy(part.positions.begin(), part.positions.end(), mesh.positions.begin() + positionBase * 3);
+	std::copy(part.texCoords.begin(), part.texCoords.end(), mesh.texCoords.begin() + texCoordBase * 2);
+	std::copy(part.normals.begin(), part.normals.end(), mesh.normals.begin() + normalBase * 3);
+
+	for(size_t i = 0; i < part.indices.size(); i++) {
+		ObjIndex corner = part.indices[i];
+		unsigned char relative = chunk.relative[i];
+
+		if(relative & RELATIVE_POSITION)
+			corner.position += positionBase;
+		if(relative & RELATIVE_TEXCOORD)
+			corner.texCoord += texCoordBase;
+		if(relative & RELATIVE_NORMAL)
+			corner.normal += normalBase;
+
+		// only relative indices can go negative, -1 would otherwise read as no attribute
+		if(corner.position < 0 || ((relative & RELATIVE_TEXCOORD) && corner.texCoord < 0)
+			|| ((relative & RELATIVE_NORMAL) && corner.normal < 0))
+			chunk.valid = false;
+
+		mesh.indices[indexBase + i] = corner;
+	}
+
+	for(size_t i = 0; i < part.materials.size(); i++) {
+		int material = part.materials[i];
+		mesh.materials[indexBase / 3 + i] = material == INHERIT_MATERIAL ? inherited : materialMap[material];
+	}
+}
+
+} // namespace
+
+bool ObjParser::parse(const std::string& fileName, ObjMesh& mesh, unsigned int threadCount) {
+	int fd = open(fileName.c_str(), O_RDONLY);
+	struct stat info;
+	bool result;
+
+	if(fd < 0)
+		return false;
+
+	if(fstat(fd, &info) != 0) {
+		close(fd);
+		return false;
+	}
+
+	// an empty file is an empty mesh
+	if(info.st_size == 0) {
+		close(fd);
+		mesh = ObjMesh();
+		return true;
+	}
+
+	void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(mapping == MAP_FAILED)
+		return false;
+
+	// the whole file is read front to back
+	madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+
+	const char *begin = static_cast<const char*>(mapping);
+	result = parse(begin, begin + info.st_size, mesh, threadCount);
+
+	munmap(mapping, info.st_size);
+	return result;
+}
+
+bool ObjParser::parse(const char *begin, const char *end, ObjMesh& mesh, unsigned int threadCount) {
+	size_t size = end - begin;
+	std::vector<const char*> bounds;
+
+	// use fewer threads for small files
+	if(threadCount == 0)
+		threadCount = 1;
+	if(size / MIN_CHUNK_SIZE < threadCount)
+		threadCount = size / MIN_CHUNK_SIZE > 0 ? size / MIN_CHUNK_SIZE : 1;
+
+	// split on line boundaries
+	bounds.push_back(begin);
+	for(unsigned int i = 1; i < threadCount; i++) {
+		const char *split = begin + size * i / threadCount;
+		if(split < bounds.back())
+			split = bounds.back();
+		bounds.push_back(skipLine(split, end));
+	}
+	bounds.push_back(end);
+
+	std::vector<Chunk> chunks(threadCount);
+	std::vector<std::thread> workers;
+
+	// parse every chunk, the calling thread takes the first one
+	for(unsigned int i = 1; i < threadCount; i++)
+		workers.push_back(std::thread(parseChunk, bounds[i], bounds[i+1], std::ref(chunks[i])));
+	parseChunk(bounds[0], bounds[1], chunks[0]);
+	for(std::thread& worker : workers)
+		worker.join();
+	workers.clear();
+
+	// find where each chunk lands in the result and number materials globally
+	std::vector<size_t> positionBase(threadCount + 1, 0), texCoordBase(threadCount + 1, 0);
+	std::vector<size_t> normalBase(threadCount + 1, 0), indexBase(threadCount + 1, 0);
+	std::vector<std::vector<int>> materialMaps(threadCount);
+	std::vector<int> inherited(threadCount, -1);
+
+	mesh = ObjMesh();
+	for(unsigned int i = 0; i < threadCount; i++) {
+		const ObjMesh& part = chunks[i].mesh;
+
+		if(!chunks[i].valid)
+			return false;
+
+		positionBase[i+1] = positionBase[i] + part.positions.size() / 3;
+		texCoordBase[i+1] = texCoordBase[i] + part.texCoords.size() / 2;
+		normalBase[i+1] = normalBase[i] + part.normals.size() / 3;
+		indexBase[i+1] = indexBase[i] + part.indices.size();
+
+		for(const std::string& name : part.materialNames) {
+			int material = -1;
+			for(size_t j = 0; j < mesh.materialNames.size(); j++)
+				if(mesh.materialNames[j] == name)
+					material = j;
+
+			if(material == -1) {
+				material = mesh.materialNames.size();
+				mesh.materialNames.push_back(name);
+			}
+			materialMaps[i].push_back(material);
+		}
+
+		// the next chunk starts with the material this chunk ended on
+		if(i + 1 < threadCount) {
+			int last = chunks[i].lastMaterial;
+			inherited[i+1] = last == INHERIT_MATERIAL ? inherited[i] : materialMaps[i][last];
+		}
+	}
+
+	mesh.positions.resize(positionBase[threadCount] * 3);
+	mesh.texCoords.resize(texCoordBase[threadCount] * 2);
+	mesh.normals.resize(normalBase[threadCount] * 3);
+	mesh.indices.resize(indexBase[threadCount]);
+	mesh.materials.resize(indexBase[threadCount] / 3);
+
+	// copy chunks into place in parallel, every chunk owns its own range
+	for(unsigned int i = 1; i < threadCount; i++) {
+		workers.push_back(std::thread(mergeChunk, std::ref(chunks[i]), std::ref(mesh), positionBase[i],
+		                              texCoordBase[i], normalBase[i], indexBase[i],
+		                              std::cref(materialMaps[i]), inherited[i]));
+	}
+	mergeChunk(chunks[0], mesh, 0, 0, 0, 0, materialMaps[0], inherited[0]);
+	for(std::thread& worker : workers)
+		worker.join();
+
+	// reject faces pointing outside of the file's data
+	for(const Chunk& chunk : chunks) {
+		if(!chunk.valid)
+			return false;
+	}
+	for(const ObjIndex& corner : mesh.indices) {
+		if(size_t(corner.position) >= positionBase[threadCount]
+			|| corner.texCoord >= int(texCoordBase[threadCount])
+			|| corner.normal >= int(normalBase[threadCount]))
+			return false;
+	}
+
+	return true;
+}
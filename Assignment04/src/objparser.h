@@ -0,0 +1,40 @@
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+#include <string>
+#include <vector>
+#include <thread>
+
+// zero based attribute indices of one face corner, -1 if the corner has none
+struct ObjIndex {
+	int position;
+	int texCoord;
+	int normal;
+};
+
+// everything read from an OBJ file, faces are triangulated as fans
+struct ObjMesh {
+	std::vector<float> positions;       // x y z per v line
+	std::vector<float> texCoords;       // u v per vt line
+	std::vector<float> normals;         // x y z per vn line
+	std::vector<ObjIndex> indices;      // 3 corners per triangle
+	std::vector<int> materials;         // material per triangle, -1 before any usemtl
+	std::vector<std::string> materialNames;
+};
+
+// memory mapped OBJ parser that splits large files across threads
+class ObjParser {
+public:
+	// parse a file, returns false if it can't be read or has bad indices
+	static bool parse(const std::string& fileName, ObjMesh& mesh,
+	                  unsigned int threadCount = std::thread::hardware_concurrency());
+
+	// parse OBJ text already in memory
+	static bool parse(const char *begin, const char *end, ObjMesh& mesh,
+	                  unsigned int threadCount = std::thread::hardware_concurrency());
+
+	// files smaller than this are parsed on one thread
+	static const size_t MIN_CHUNK_SIZE = 256 * 1024;
+};
+
+#endif // OBJ_PARSER_H
@@ -0,0 +1,43 @@
+// checks that ObjParser accepts valid indices and rejects ones pointing outside the file
+// usage: ./objtest, prints failed checks and returns nonzero if any failed
+#include <iostream>
+#include <string>
+
+#include "objparser.h"
+
+static int failures = 0;
+
+// parse text on the given threads and compare the result with what is expected
+static void check(const std::string& name, const std::string& text, bool expected, unsigned int threads = 1) {
+	ObjMesh mesh;
+	bool result = ObjParser::parse(text.data(), text.data() + text.size(), mesh, threads);
+	if(result != expected) {
+		std::cout << "FAILED: " << name << " returned " << result << std::endl;
+		failures++;
+	}
+}
+
+int main() {
+	const std::string triangle = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 1\n";
+
+	check("absolute indices", triangle + "f 1/1/1 2/1/1 3/1/1\n", true);
+	check("negative indices", triangle + "f -3/-1/-1 -2/-1/-1 -1/-1/-1\n", true);
+	check("position out of range", triangle + "f 1 2 4\n", false);
+	check("negative position out of range", triangle + "f -4 -2 -1\n", false);
+	check("texture coordinate out of range", triangle + "f 1/2 2/1 3/1\n", false);
+	check("negative texture coordinate out of range", triangle + "f 1/-5 2/1 3/1\n", false);
+	check("normal out of range", triangle + "f 1//2 2//1 3//1\n", false);
+	check("negative normal resolving to -1", triangle + "f 1//-2 2//1 3//1\n", false);
+	check("zero index", triangle + "f 0 1 2\n", false);
+
+	// negative indices in the second chunk may point back into the first one
+	std::string large;
+	while(large.size() < 2 * ObjParser::MIN_CHUNK_SIZE)
+		large += triangle + "f -3/-1/-1 -2/-1/-1 -1/-1/-1\n";
+	check("negative indices across chunks", large, true, 2);
+	check("negative normal out of range across chunks", "f 1//-1 1//-1 1//-1\n" + large, false, 2);
+
+	if(failures == 0)
+		std::cout << "All checks passed" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,23 @@
+#include "assetregistry.h"
+
+#include <iostream>
+
+std::map<std::string, std::weak_ptr<MeshAsset>> AssetRegistry::meshes;
+
+std::shared_ptr<MeshAsset> AssetRegistry::acquireMesh(const std::string& modelFile, bool dynamic)
+{
+	// static and dynamic objects of one model need different collision shapes
+	std::string key = modelFile + (dynamic ? " dynamic" : " static");
+
+	// if mesh is still alive, share it
+	auto mesh = meshes[key].lock();
+	if(mesh) {
+		std::cout << "Shared mesh: " << modelFile << " (" << mesh.use_count()-1 << " users)" << std::endl;
+		return mesh;
+	}
+
+	// otherwise load it and remember it
+	mesh = std::make_shared<MeshAsset>(modelFile, dynamic);
+	meshes[key] = mesh;
+	return mesh;
+}
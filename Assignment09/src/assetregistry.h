@@ -0,0 +1,22 @@
+#ifndef ASSET_REGISTRY_H
+#define ASSET_REGISTRY_H
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "meshasset.h"
+
+// hands out shared meshes so every model file is loaded once,
+// a mesh is released when the last object using it goes away
+class AssetRegistry
+{
+public:
+	// get a loaded mesh or load it on first use
+	static std::shared_ptr<MeshAsset> acquireMesh(const std::string& modelFile, bool dynamic);
+
+private:
+	static std::map<std::string, std::weak_ptr<MeshAsset>> meshes;
+};
+
+#endif // ASSET_REGISTRY_H
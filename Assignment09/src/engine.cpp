@@ -40,6 +40,17 @@ btRigidBody *Engine::body1 = nullptr, *Engine::body2 = nullptr;
 void Engine::init(int argc, char **argv)
 {
 	glutInit(&argc, argv);
+
+	// parse command line options left over by glut
+	for(int i = 1; i < argc; i++) {
+		std::string option(argv[i]);
+
+		if(option == "--shape-cache")
+			MeshAsset::serializedShapes = true;
+		else
+			std::cerr << "Unknown option: " << option << std::endl;
+	}
+
 	glutInitDisplayMode(GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGBA);
 	glutInitWindowSize(width,height);
 	glutCreateWindow("Air Hockey");
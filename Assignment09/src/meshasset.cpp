@@ -0,0 +1,90 @@
+#include "meshasset.h"
+#include "shapecache.h"
+
+#include <chrono>
+#include <iostream>
+
+bool MeshAsset::serializedShapes = false;
+
+MeshAsset::MeshAsset(const std::string& modelFile, bool dynamic)
+    : ml(modelFile.c_str()), mesh(nullptr), shape(nullptr), importer(nullptr)
+{
+	auto geo = ml.load(triangleCount, textureCount);
+
+    // Create a Vertex Buffer object to store this vertex info on the GPU
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * geo.size(), geo.data(), GL_STATIC_DRAW);
+
+	// the static table and its bvh can be loaded from the shape cache,
+	// time it against building so the cache can be compared
+	bool cached = !dynamic && serializedShapes;
+	auto start = std::chrono::high_resolution_clock::now();
+	if(cached)
+		shape = ShapeCache::read(modelFile, importer);
+
+	if(!shape) {
+		mesh = new btTriangleMesh();
+		for(unsigned int i = 0; i < geo.size(); i+=3) {
+			mesh->addTriangle(btVector3(geo[i].position[0], geo[i].position[1], geo[i].position[2]),
+							  btVector3(geo[i+1].position[0], geo[i+1].position[1], geo[i+1].position[2]),
+							  btVector3(geo[i+2].position[0], geo[i+2].position[1], geo[i+2].position[2]));
+		}
+
+		if(dynamic) {
+			shape = new btConvexTriangleMeshShape(mesh);
+		}
+		else {
+			shape = new btBvhTriangleMeshShape(mesh,true);
+		}
+	}
+
+	if(cached) {
+		auto end = std::chrono::high_resolution_clock::now();
+		double ms = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end-start).count();
+		std::cout << "Collision shape of " << modelFile << (importer ? " loaded from cache" : " built")
+		          << " in " << ms << " ms" << std::endl;
+
+		if(!importer)
+			ShapeCache::write(modelFile, shape);
+	}
+}
+
+MeshAsset::~MeshAsset()
+{
+	if(importer) {
+		importer->deleteAllData();
+		delete importer;
+	}
+	else {
+		delete shape;
+		delete mesh;
+	}
+
+	glDeleteBuffers(1, &vbo);
+}
+
+GLuint MeshAsset::getVBO() const
+{
+	return vbo;
+}
+
+int MeshAsset::getTriangleCount() const
+{
+	return triangleCount;
+}
+
+int MeshAsset::getTextureCount() const
+{
+	return textureCount;
+}
+
+GLuint MeshAsset::getTexture(int index) const
+{
+	return ml.getTexture(index);
+}
+
+btCollisionShape* MeshAsset::getShape() const
+{
+	return shape;
+}
@@ -0,0 +1,44 @@
+#ifndef MESH_ASSET_H
+#define MESH_ASSET_H
+
+#include <GL/glew.h>
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletWorldImporter/btBulletWorldImporter.h>
+
+#include <string>
+
+#include "vertex.h"
+#include "modelloader.h"
+
+// vertex buffer, textures and collision shape of one model file,
+// shared by every SimObject made from that file
+class MeshAsset
+{
+public:
+	// dynamic objects collide as a convex hull, static ones as a bvh triangle mesh
+	MeshAsset(const std::string& modelFile, bool dynamic);
+	~MeshAsset();
+	MeshAsset(const MeshAsset& other) = delete;
+
+	GLuint getVBO() const;
+	int getTriangleCount() const;
+	int getTextureCount() const;
+	GLuint getTexture(int index) const;
+	btCollisionShape* getShape() const;
+
+	// load static collision shapes from .bullet caches instead of building them
+	static bool serializedShapes;
+
+private:
+	ModelLoader ml;
+	GLuint vbo;
+	int triangleCount, textureCount;
+
+	// a shape loaded from the shape cache belongs to its importer
+	btTriangleMesh *mesh;
+	btCollisionShape *shape;
+	btBulletWorldImporter *importer;
+};
+
+#endif // MESH_ASSET_H
@@ -0,0 +1,94 @@
+#include "shapecache.h"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+btCollisionShape* ShapeCache::read(const std::string& modelFile, btBulletWorldImporter*& importer)
+{
+	std::string name = shapeName(modelFile);
+	if(name.empty())
+		return nullptr;
+
+	// bullet parses the file in place, so read it into a writable buffer
+	std::ifstream fin(cacheName(modelFile), std::ios::binary);
+	std::vector<char> buffer((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+	if(buffer.empty())
+		return nullptr;
+
+	// only a shape stored under the current name matches the model
+	btBulletWorldImporter *loaded = new btBulletWorldImporter();
+	btCollisionShape *shape = nullptr;
+	if(loaded->loadFileFromMemory(buffer.data(), int(buffer.size())))
+		shape = loaded->getCollisionShapeByName(name.c_str());
+
+	if(!shape) {
+		loaded->deleteAllData();
+		delete loaded;
+		return nullptr;
+	}
+
+	importer = loaded;
+	return shape;
+}
+
+bool ShapeCache::write(const std::string& modelFile, const btCollisionShape *shape)
+{
+	std::string name = shapeName(modelFile);
+	if(name.empty())
+		return false;
+
+	// serialize the shape with its mesh and quantized bvh
+	btDefaultSerializer serializer;
+	serializer.startSerialization();
+	serializer.registerNameForPointer(shape, name.c_str());
+	shape->serializeSingleShape(&serializer);
+	serializer.finishSerialization();
+
+	// write to a temporary file and rename so readers never see a partial cache
+	std::string tempName = cacheName(modelFile) + ".tmp";
+	std::ofstream fout(tempName, std::ios::binary | std::ios::trunc);
+	fout.write(reinterpret_cast<const char*>(serializer.getBufferPointer()), serializer.getCurrentBufferSize());
+	fout.close();
+
+	if(!fout || std::rename(tempName.c_str(), cacheName(modelFile).c_str()) != 0) {
+		std::cerr << "Unable to write shape cache: " << cacheName(modelFile) << std::endl;
+		std::remove(tempName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::string ShapeCache::cacheName(const std::string& modelFile)
+{
+	return modelFile + ".bullet";
+}
+
+std::string ShapeCache::shapeName(const std::string& modelFile)
+{
+	struct stat info;
+	if(stat(modelFile.c_str(), &info) != 0)
+		return std::string();
+
+	// FNV-1a over the model file so edits that keep size and time are noticed
+	std::ifstream fin(modelFile, std::ios::binary);
+	uint64_t hash = 14695981039346656037ull;
+	char buffer[65536];
+	while(fin.read(buffer, sizeof(buffer)) || fin.gcount() > 0) {
+		for(std::streamsize i = 0; i < fin.gcount(); i++) {
+			hash ^= static_cast<unsigned char>(buffer[i]);
+			hash *= 1099511628211ull;
+		}
+	}
+
+	std::ostringstream name;
+	name << modelFile << " " << info.st_mtime << " " << info.st_size << " " << std::hex << hash;
+	return name.str();
+}
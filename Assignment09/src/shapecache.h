@@ -0,0 +1,28 @@
+#ifndef SHAPE_CACHE_H
+#define SHAPE_CACHE_H
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletWorldImporter/btBulletWorldImporter.h>
+
+#include <string>
+
+// collision shape with its bvh written with bullet's serializer, stored
+// next to the model file as a regular .bullet file
+class ShapeCache
+{
+public:
+	// load the shape of a model if the cache matches the model,
+	// the importer owns the shape and its mesh data
+	static btCollisionShape* read(const std::string& modelFile, btBulletWorldImporter*& importer);
+
+	// write the shape of a model
+	static bool write(const std::string& modelFile, const btCollisionShape *shape);
+
+	static std::string cacheName(const std::string& modelFile);
+
+private:
+	// name the shape is stored under, changes with the model file
+	static std::string shapeName(const std::string& modelFile);
+};
+
+#endif // SHAPE_CACHE_H
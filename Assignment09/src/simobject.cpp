@@ -1,18 +1,11 @@
 #include "simobject.h"
 #include "engine.h"
+#include "assetregistry.h"
+
 
 SimObject::SimObject(GLuint program, btScalar mass, std::string modelFile, btVector3 vec)
-    : ml(modelFile.c_str())
+    : asset(AssetRegistry::acquireMesh(modelFile, mass > 0))
 {
-	auto geo = ml.load(triangleCount, textureCount);
-	Vertex *geometry = new Vertex[geo.size()];
-	for(unsigned int i = 0; i < geo.size(); i++)
-		geometry[i] = geo[i];
-    // Create a Vertex Buffer object to store this vertex info on the GPU
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(*geometry) * geo.size(), geometry, GL_STATIC_DRAW);
-
 	loc_mvp = glGetUniformLocation(program, "mvpMatrix");
 	loc_position = glGetAttribLocation(program, "v_position");
 	loc_texture = glGetUniformLocation(program,"tex");
@@ -32,21 +25,7 @@ SimObject::SimObject(GLuint program, btScalar mass, std::string modelFile, btVec
 			throw std::runtime_error("Unable to get locations in SimObject::SimObject()");
 		}
 
-	btTriangleMesh *mesh = new btTriangleMesh();
-	for(unsigned int i = 0; i < geo.size(); i+=3) {
-		mesh->addTriangle(btVector3(geometry[i].position[0], geometry[i].position[1], geometry[i].position[2]),
-						  btVector3(geometry[i+1].position[0], geometry[i+1].position[1], geometry[i+1].position[2]),
-						  btVector3(geometry[i+2].position[0], geometry[i+2].position[1], geometry[i+2].position[2]));
-
-	}
-
-	btCollisionShape * shape;
-	if(mass > 0) {
-		shape = new btConvexTriangleMeshShape(mesh);
-	}
-	else {
-		shape = new btBvhTriangleMeshShape(mesh,true);
-	}
+	btCollisionShape *shape = asset->getShape();
 
 	btDefaultMotionState* fallMotionState = new btDefaultMotionState(btTransform(btQuaternion(0,0,0,1), vec));
 	btVector3 fallInertia(0,0,0);
@@ -107,7 +86,7 @@ void SimObject::render()
     glEnableVertexAttribArray(loc_texCoord);
     glEnableVertexAttribArray(loc_color);
     
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, asset->getVBO());
     //set pointers into the vbo for each of the attributes(position and color)
     glVertexAttribPointer( loc_position,//location of attribute
                            3,//number of elements
@@ -130,16 +109,17 @@ void SimObject::render()
                            sizeof(Vertex),
                            (void*)offsetof(Vertex,color));
                            
+    int textureCount = asset->getTextureCount();
     glUniform1i(loc_hasTexture, textureCount);
                            
 	for(int i = 0; i < textureCount; i++) {
 		glUniform1i(loc_texture,i);
 		glActiveTexture(GL_TEXTURE0 + i);	
-		glBindTexture(GL_TEXTURE_2D,ml.getTexture(i));
+		glBindTexture(GL_TEXTURE_2D,asset->getTexture(i));
 		glUniform1i(loc_texture,i);
 	}
 
-    glDrawArrays(GL_TRIANGLES, 0, triangleCount*3);//mode, starting index, count
+    glDrawArrays(GL_TRIANGLES, 0, asset->getTriangleCount()*3);//mode, starting index, count
 
 	glDisableVertexAttribArray(loc_position);
     glDisableVertexAttribArray(loc_texCoord);
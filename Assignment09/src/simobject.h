@@ -11,9 +11,10 @@
 
 #include <string>
 #include <stdexcept>
+#include <memory>
 
 #include "vertex.h"
-#include "modelloader.h"
+#include "meshasset.h"
 
 class SimObject
 {
@@ -36,11 +37,11 @@ protected:
 	GLint loc_hasTexture;
 	GLint loc_color;
 	
-	GLuint vbo;
-	int triangleCount, textureCount;
     bool hasTexture;
 	glm::mat4 model;
-	ModelLoader ml;
+
+	// shared with every object of the same model, objects differ in transform and body
+	std::shared_ptr<MeshAsset> asset;
 	
 	btRigidBody *meshBody;
 };
@@ -0,0 +1,8 @@
+uniform sampler2D atlas;
+varying vec2 tex_coords;
+varying vec3 color;
+
+void main(void) {
+    // glyphs are white on clear, so the atlas only decides coverage
+    gl_FragColor = vec4(color, texture2D(atlas, tex_coords).a);
+}
@@ -0,0 +1,16 @@
+attribute vec4 v_position;
+attribute vec2 v_texCoord;
+attribute vec3 v_color;
+varying vec2 tex_coords;
+varying vec3 color;
+uniform vec2 screenSize;
+
+void main(void) {
+    // start of the text in screen coordinates plus the glyph corner in pixels
+    vec2 pos = v_position.xy + v_position.zw * 2.0 / screenSize;
+
+    tex_coords = v_texCoord;
+    color = v_color;
+
+    gl_Position = vec4(pos, 0.0, 1.0);
+}
@@ -1,34 +1,68 @@
+#ifdef UNIFORM_BLOCKS
+#extension GL_ARB_uniform_buffer_object : require
+#endif
+
 attribute vec3 v_position;
 attribute vec2 v_texCoord;
 attribute vec3 v_color;
 attribute vec3 v_normal;
 varying vec2 tex_coords;
 varying vec4 color;
+attribute mat4 v_model;
+
+#ifdef UNIFORM_BLOCKS
+// matrices of the object, bound from the uniform ring
+layout(std140) uniform ObjectMatrices {
+    mat4 mvpMatrix;
+    mat4 normalMatrix;
+};
+#else
 uniform mat4 mvpMatrix;
+uniform mat4 normalMatrix;
+#endif
+
+uniform bool instanced;
 uniform bool hasTexture;
 uniform vec4 ambient, diffuse, specular;
-uniform vec4 lightPosition;
 uniform float shininess;
 
+// must match LightArray::MAX_LIGHTS
+const int MAX_LIGHTS = 64;
+uniform vec4 lightPositions[MAX_LIGHTS];
+uniform int lightCount;
+
 void main(void) {
+    // instanced draws pass view projection and a model matrix per instance
+    mat4 mvp = instanced ? mvpMatrix * v_model : mvpMatrix;
+
     // get vertex position
-    vec3 pos = (mvpMatrix * vec4(v_position,0.0)).xyz;
+    vec3 pos = (mvp * vec4(v_position,0.0)).xyz;
 
-    // calculate lighting variables
-    vec3 L = normalize(lightPosition.xyz - pos);
+    // calculate lighting variables shared by all lights
     vec3 E = normalize(-pos);
-    vec3 H = normalize(L + E);
-    vec3 N = normalize(mvpMatrix * vec4(v_normal, 0.0)).xyz;
+    // the normal matrix is the camera's, rotated by the model on the CPU or per instance here
+    vec4 normal = instanced ? v_model * vec4(v_normal, 0.0) : vec4(v_normal, 0.0);
+    vec3 N = normalize((normalMatrix * normal).xyz);
+
+    vec4 diffuseValue = vec4(0.0,0.0,0.0,0.0);
+    vec4 specularValue = vec4(0.0,0.0,0.0,0.0);
+
+    // add up diffuse and specular light of every light
+    for(int i = 0; i < MAX_LIGHTS; i++) {
+        if(i >= lightCount)
+            break;
 
-    float kd = max(dot(L,N), 0.0);
-    vec4 diffuseValue = kd * diffuse;
+        vec3 L = normalize(lightPositions[i].xyz - pos);
+        vec3 H = normalize(L + E);
 
-    float ks = pow(max(dot(N,H), 0.0), shininess);
-    vec4 specularValue = ks * specular;
+        float kd = max(dot(L,N), 0.0);
+        diffuseValue += kd * diffuse;
 
-    // if no light specular color should be black
-    if(dot(L,N) < 0.0) {
-        specularValue = vec4(0.0,0.0,0.0,0.0);
+        // if no light specular color should be black
+        if(dot(L,N) >= 0.0) {
+            float ks = pow(max(dot(N,H), 0.0), shininess);
+            specularValue += ks * specular;
+        }
     }
 
 	tex_coords = v_texCoord;
@@ -47,5 +81,5 @@ void main(void) {
 	}
 
     // set vertex position
-    gl_Position = mvpMatrix * vec4(v_position, 1.0);
+    gl_Position = mvp * vec4(v_position, 1.0);
 }
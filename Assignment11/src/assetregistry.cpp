@@ -0,0 +1,176 @@
+#include "assetregistry.h"
+
+// initialize all static variables
+std::map<std::string, std::weak_ptr<MeshAsset>> AssetRegistry::meshes;
+std::map<std::string, std::shared_ptr<MeshAsset>> AssetRegistry::preloaded;
+std::map<std::string, std::weak_ptr<Texture>> AssetRegistry::textures;
+std::map<std::string, std::shared_future<std::shared_ptr<const TextureImage>>> AssetRegistry::decoding;
+std::set<std::string> AssetRegistry::pending;
+std::deque<AssetRegistry::Upload> AssetRegistry::uploads;
+std::mutex AssetRegistry::mutex;
+std::condition_variable AssetRegistry::loaded;
+
+std::shared_ptr<MeshAsset> AssetRegistry::acquireMesh(const std::string& modelFile)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// if the model is being preloaded, upload finished loads until it is done
+	while(pending.count(modelFile)) {
+		lock.unlock();
+		processUploads(true);
+		lock.lock();
+	}
+
+	// hand out a preloaded mesh, the registry stops keeping it alive
+	auto found = preloaded.find(modelFile);
+	if(found != preloaded.end()) {
+		auto mesh = found->second;
+		preloaded.erase(found);
+		return mesh;
+	}
+
+	// if mesh is still alive, share it
+	auto mesh = meshes[modelFile].lock();
+	if(mesh) {
+		std::cout << "Shared mesh: " << modelFile << " (" << mesh.use_count()-1 << " users)" << std::endl;
+		return mesh;
+	}
+
+	// otherwise load it on this thread and remember it
+	lock.unlock();
+	mesh = std::make_shared<MeshAsset>(modelFile);
+	mesh->upload();
+
+	lock.lock();
+	meshes[modelFile] = mesh;
+	return mesh;
+}
+
+std::shared_ptr<Texture> AssetRegistry::acquireTexture(const std::string& textureFile,
+	const TextureImage *image)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// if texture is still alive, share it
+	auto texture = textures[textureFile].lock();
+	if(texture) {
+		std::cout << "Shared texture: " << textureFile << std::endl;
+		return texture;
+	}
+
+	// decode here if no worker did it
+	std::shared_ptr<const TextureImage> decoded;
+	if(!image) {
+		lock.unlock();
+		decoded = decodeTexture(textureFile);
+		image = decoded.get();
+		lock.lock();
+	}
+
+	// the decoded image is no longer needed once it is uploaded
+	decoding.erase(textureFile);
+
+	if(!image)
+		return nullptr;
+
+	// otherwise upload it and remember it
+	texture = std::make_shared<Texture>(ModelLoader::uploadTexture(*image));
+	textures[textureFile] = texture;
+	return texture;
+}
+
+std::shared_ptr<const TextureImage> AssetRegistry::decodeTexture(const std::string& textureFile)
+{
+	std::promise<std::shared_ptr<const TextureImage>> result;
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// nothing to decode if the texture is already uploaded
+	if(!textures[textureFile].expired())
+		return nullptr;
+
+	// if another thread is decoding this texture, wait for its result
+	auto found = decoding.find(textureFile);
+	if(found != decoding.end()) {
+		auto future = found->second;
+		lock.unlock();
+		return future.get();
+	}
+
+	decoding[textureFile] = result.get_future().share();
+	lock.unlock();
+
+	// decode outside of the lock
+	auto image = std::make_shared<TextureImage>();
+	if(!ModelLoader::decodeTexture(textureFile.c_str(), *image))
+		image.reset();
+
+	result.set_value(image);
+	return image;
+}
+
+void AssetRegistry::preload(const std::vector<std::string>& modelFiles)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for(const std::string& modelFile : modelFiles) {
+		// skip models that are loaded or already loading
+		if(pending.count(modelFile) || preloaded.count(modelFile) || !meshes[modelFile].expired())
+			continue;
+
+		pending.insert(modelFile);
+
+		// do the CPU work on a worker and queue the result for the GL thread
+		workers().enqueue([modelFile]() {
+			Upload upload;
+			upload.file = modelFile;
+
+			try {
+				upload.mesh = std::make_shared<MeshAsset>(modelFile);
+			}
+			catch(...) {
+				upload.error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			uploads.push_back(upload);
+			loaded.notify_all();
+		});
+	}
+}
+
+int AssetRegistry::processUploads(bool wait)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// wait for a finished load if anything is still pending
+	if(wait)
+		loaded.wait(lock, []() { return !uploads.empty() || pending.empty(); });
+
+	while(!uploads.empty()) {
+		Upload upload = uploads.front();
+		uploads.pop_front();
+
+		// upload outside of the lock so workers can keep queueing
+		lock.unlock();
+		if(upload.error) {
+			lock.lock();
+			pending.erase(upload.file);
+			std::rethrow_exception(upload.error);
+		}
+		upload.mesh->upload();
+		lock.lock();
+
+		// keep the mesh alive until someone acquires it
+		pending.erase(upload.file);
+		preloaded[upload.file] = upload.mesh;
+		meshes[upload.file] = upload.mesh;
+	}
+
+	return pending.size();
+}
+
+ThreadPool& AssetRegistry::workers()
+{
+	static ThreadPool pool;
+	return pool;
+}
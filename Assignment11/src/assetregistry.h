@@ -0,0 +1,66 @@
+#ifndef ASSET_REGISTRY_H
+#define ASSET_REGISTRY_H
+
+#include <map>
+#include <set>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include "meshasset.h"
+#include "modelloader.h"
+#include "threadpool.h"
+
+// hands out shared handles so every model and texture file is loaded once,
+// assets are released when the last handle to them goes away
+class AssetRegistry
+{
+public:
+	// get a loaded mesh or load it on first use, waits for a pending preload
+	static std::shared_ptr<MeshAsset> acquireMesh(const std::string& modelFile);
+
+	// get a loaded texture or upload it on first use, decodes the file if no
+	// image is given, null if loading failed
+	static std::shared_ptr<Texture> acquireTexture(const std::string& textureFile,
+		const TextureImage *image = nullptr);
+
+	// decode a texture once even when several workers ask for it,
+	// null if the texture is already uploaded or cannot be decoded
+	static std::shared_ptr<const TextureImage> decodeTexture(const std::string& textureFile);
+
+	// start loading models on the worker pool
+	static void preload(const std::vector<std::string>& modelFiles);
+
+	// upload finished loads on the GL thread, optionally waiting for at least one,
+	// returns the number of loads still pending
+	static int processUploads(bool wait = false);
+
+private:
+	// result of a worker load waiting for the GL thread
+	struct Upload
+	{
+		std::string file;
+		std::shared_ptr<MeshAsset> mesh;
+		std::exception_ptr error;
+	};
+
+	// worker pool created on first use
+	static ThreadPool& workers();
+
+	// member variables, guarded by mutex
+	static std::map<std::string, std::weak_ptr<MeshAsset>> meshes;
+	static std::map<std::string, std::shared_ptr<MeshAsset>> preloaded;
+	static std::map<std::string, std::weak_ptr<Texture>> textures;
+	static std::map<std::string, std::shared_future<std::shared_ptr<const TextureImage>>> decoding;
+	static std::set<std::string> pending;
+	static std::deque<Upload> uploads;
+	static std::mutex mutex;
+	static std::condition_variable loaded;
+};
+
+#endif // ASSET_REGISTRY_H
@@ -0,0 +1,396 @@
+#include "convexdecomposition.h"
+
+#include <LinearMath/btConvexHullComputer.h>
+
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <limits>
+#include <algorithm>
+
+namespace {
+
+// triangle clipped by split planes, may have more than three corners
+typedef std::vector<btVector3> Polygon;
+
+// piece of a connected part of the model and its hull
+struct Part
+{
+	std::vector<Polygon> polygons;
+	btVector3 min, max;
+	std::vector<btVector3> hull;
+	float concavity;
+};
+
+// call visit for points spread over a triangle no more than spacing apart
+template <typename Visitor>
+void sampleTriangle(const btVector3& a, const btVector3& b, const btVector3& c,
+	btScalar spacing, Visitor visit)
+{
+	btScalar longest = std::max(a.distance(b), std::max(b.distance(c), c.distance(a)));
+	int steps = std::max(1, int(std::ceil(longest / spacing)));
+
+	for(int i = 0; i <= steps; i++)
+		for(int j = 0; i + j <= steps; j++)
+			visit(a + (b - a) * (btScalar(i) / steps) + (c - a) * (btScalar(j) / steps));
+}
+
+// distance from every voxel to the nearest voxel the surface passes through
+class DistanceField
+{
+public:
+	DistanceField(const std::vector<Polygon>& triangles, const btVector3& min,
+		const btVector3& max, int resolution, btScalar tolerance)
+	{
+		btVector3 extent = max - min;
+		cell = extent[extent.maxAxis()] / std::max(resolution, 1);
+
+		// voxels much finer than the allowed gap only cost time
+		cell = std::max(cell, tolerance * 0.25f);
+		if(cell <= 0)
+			cell = 1;
+
+		// pad the grid by two voxels so hull samples never fall outside
+		origin = min - btVector3(2*cell, 2*cell, 2*cell);
+		nx = int(extent.x() / cell) + 5;
+		ny = int(extent.y() / cell) + 5;
+		nz = int(extent.z() / cell) + 5;
+		distances.assign(size_t(nx) * ny * nz, std::numeric_limits<float>::max());
+
+		// voxels touched by the surface are at distance zero
+		for(const Polygon& triangle : triangles)
+			sampleTriangle(triangle[0], triangle[1], triangle[2], cell * 0.5f,
+				[this](const btVector3& p) { distances[index(p)] = 0; });
+
+		// two pass chamfer transform over the 26 neighbours of each voxel
+		sweep(1);
+		sweep(-1);
+	}
+
+	float at(const btVector3& point) const
+	{
+		return distances[index(point)];
+	}
+
+	btScalar cellSize() const
+	{
+		return cell;
+	}
+
+private:
+	size_t index(const btVector3& point) const
+	{
+		btVector3 local = (point - origin) / cell;
+		int x = std::min(std::max(int(local.x()), 0), nx-1);
+		int y = std::min(std::max(int(local.y()), 0), ny-1);
+		int z = std::min(std::max(int(local.z()), 0), nz-1);
+		return (size_t(z) * ny + y) * nx + x;
+	}
+
+	// relax every voxel against the neighbours already visited in this direction
+	void sweep(int direction)
+	{
+		int offsets[13][3];
+		float weights[13];
+		int count = 0;
+
+		for(int dz = -1; dz <= 0; dz++)
+			for(int dy = -1; dy <= 1; dy++)
+				for(int dx = -1; dx <= 1; dx++) {
+					if(dz == 0 && (dy > 0 || (dy == 0 && dx >= 0)))
+						continue;
+					offsets[count][0] = dx * direction;
+					offsets[count][1] = dy * direction;
+					offsets[count][2] = dz * direction;
+					weights[count++] = cell * std::sqrt(float(dx*dx + dy*dy + dz*dz));
+				}
+
+		for(int i = 0; i < nz; i++) {
+			int z = direction > 0 ? i : nz-1 - i;
+			for(int j = 0; j < ny; j++) {
+				int y = direction > 0 ? j : ny-1 - j;
+				for(int k = 0; k < nx; k++) {
+					int x = direction > 0 ? k : nx-1 - k;
+					float& distance = distances[(size_t(z) * ny + y) * nx + x];
+
+					for(int n = 0; n < 13; n++) {
+						int ox = x + offsets[n][0], oy = y + offsets[n][1], oz = z + offsets[n][2];
+						if(ox < 0 || oy < 0 || oz < 0 || ox >= nx || oy >= ny || oz >= nz)
+							continue;
+
+						float neighbour = distances[(size_t(oz) * ny + oy) * nx + ox];
+						if(neighbour + weights[n] < distance)
+							distance = neighbour + weights[n];
+					}
+				}
+			}
+		}
+	}
+
+	btVector3 origin;
+	btScalar cell;
+	int nx, ny, nz;
+	std::vector<float> distances;
+};
+
+// keep the part of a polygon on one side of an axis plane
+Polygon clip(const Polygon& polygon, int axis, btScalar value, bool below)
+{
+	Polygon result;
+
+	for(size_t i = 0; i < polygon.size(); i++) {
+		const btVector3& a = polygon[i];
+		const btVector3& b = polygon[(i+1) % polygon.size()];
+		btScalar da = below ? value - a[axis] : a[axis] - value;
+		btScalar db = below ? value - b[axis] : b[axis] - value;
+
+		if(da >= 0)
+			result.push_back(a);
+		if((da >= 0) != (db >= 0))
+			result.push_back(a + (b - a) * (da / (da - db)));
+	}
+
+	return result;
+}
+
+// compute bounds, hull and the largest gap between hull and surface
+void measure(Part& part, const DistanceField& field)
+{
+	std::vector<btVector3> points;
+	for(const Polygon& polygon : part.polygons)
+		points.insert(points.end(), polygon.begin(), polygon.end());
+
+	part.min = part.max = points[0];
+	for(const btVector3& point : points) {
+		part.min.setMin(point);
+		part.max.setMax(point);
+	}
+
+	btConvexHullComputer computer;
+	computer.compute(&points[0].getX(), sizeof(btVector3), int(points.size()), 0, 0);
+
+	part.hull.clear();
+	for(int i = 0; i < computer.vertices.size(); i++)
+		part.hull.push_back(computer.vertices[i]);
+
+	// sample every hull face and look up how far it is from the surface
+	part.concavity = 0;
+	for(int f = 0; f < computer.faces.size(); f++) {
+		const btConvexHullComputer::Edge *first = &computer.edges[computer.faces[f]];
+		const btConvexHullComputer::Edge *edge = first->getNextEdgeOfFace();
+		const btVector3& corner = computer.vertices[first->getSourceVertex()];
+
+		for(; edge->getTargetVertex() != first->getSourceVertex(); edge = edge->getNextEdgeOfFace())
+			sampleTriangle(corner, computer.vertices[edge->getSourceVertex()],
+				computer.vertices[edge->getTargetVertex()], field.cellSize(),
+				[&](const btVector3& p) { part.concavity = std::max(part.concavity, field.at(p)); });
+	}
+}
+
+// cut a part in half across one of its axes, choosing the cut with the smallest gaps
+bool split(const Part& part, const DistanceField& field, Part& below, Part& above)
+{
+	btVector3 extent = part.max - part.min;
+	float best = std::numeric_limits<float>::max();
+
+	for(int axis = 0; axis < 3; axis++) {
+		if(extent[axis] < 2 * field.cellSize())
+			continue;
+
+		btScalar value = part.min[axis] + extent[axis] * 0.5f;
+		Part a, b;
+
+		for(const Polygon& polygon : part.polygons) {
+			Polygon clipped = clip(polygon, axis, value, true);
+			if(clipped.size() >= 3)
+				a.polygons.push_back(clipped);
+
+			clipped = clip(polygon, axis, value, false);
+			if(clipped.size() >= 3)
+				b.polygons.push_back(clipped);
+		}
+
+		if(a.polygons.empty() || b.polygons.empty())
+			continue;
+
+		measure(a, field);
+		measure(b, field);
+
+		if(std::max(a.concavity, b.concavity) < best) {
+			best = std::max(a.concavity, b.concavity);
+			below = std::move(a);
+			above = std::move(b);
+		}
+	}
+
+	return best < std::numeric_limits<float>::max();
+}
+
+// read the triangles of the full detail level
+std::vector<Polygon> meshTriangles(const MeshData& mesh)
+{
+	std::vector<Polygon> triangles;
+	uint32_t count = mesh.indexCount == 0 ? mesh.vertexCount
+		: mesh.lods.empty() ? mesh.indexCount : mesh.lods[0].indexCount;
+
+	for(uint32_t i = 0; i + 2 < count; i += 3) {
+		Polygon triangle;
+
+		for(uint32_t j = i; j < i + 3; j++) {
+			uint32_t index = j;
+			if(mesh.indexCount > 0 && mesh.indexType == MeshData::UINT16)
+				index = static_cast<const uint16_t*>(mesh.indices)[j];
+			else if(mesh.indexCount > 0)
+				index = static_cast<const uint32_t*>(mesh.indices)[j];
+
+			const float *position = mesh.vertices[index].position;
+			triangle.push_back(btVector3(position[0], position[1], position[2]));
+		}
+
+		// degenerate triangles add nothing to the surface
+		if((triangle[1] - triangle[0]).cross(triangle[2] - triangle[0]).length2() > 0)
+			triangles.push_back(triangle);
+	}
+
+	return triangles;
+}
+
+// group triangles sharing corner positions into connected parts
+std::vector<Part> connectedParts(const std::vector<Polygon>& triangles)
+{
+	std::map<std::tuple<btScalar, btScalar, btScalar>, int> corners;
+	std::vector<int> parent;
+
+	auto find = [&](int i) {
+		while(parent[i] != i)
+			i = parent[i] = parent[parent[i]];
+		return i;
+	};
+
+	std::vector<int> triangleCorner(triangles.size());
+	for(size_t t = 0; t < triangles.size(); t++) {
+		int root = -1;
+
+		for(const btVector3& p : triangles[t]) {
+			auto found = corners.emplace(std::make_tuple(p.x(), p.y(), p.z()), int(parent.size()));
+			if(found.second)
+				parent.push_back(found.first->second);
+
+			int corner = find(found.first->second);
+			if(root >= 0 && corner != root)
+				parent[corner] = root;
+			else
+				root = corner;
+		}
+
+		triangleCorner[t] = root;
+	}
+
+	std::map<int, size_t> partIndex;
+	std::vector<Part> parts;
+	for(size_t t = 0; t < triangles.size(); t++) {
+		auto found = partIndex.emplace(find(triangleCorner[t]), parts.size());
+		if(found.second)
+			parts.push_back(Part());
+		parts[found.first->second].polygons.push_back(triangles[t]);
+	}
+
+	return parts;
+}
+
+} // namespace
+
+ConvexDecomposition::Settings::Settings()
+	: concavity(0.1f), resolution(256), maxHulls(256)
+{
+}
+
+ConvexHulls ConvexDecomposition::decompose(const MeshData& mesh, const Settings& settings)
+{
+	std::vector<Polygon> triangles = meshTriangles(mesh);
+	if(triangles.empty())
+		return ConvexHulls();
+
+	// measure gaps against a voxelized copy of the whole surface
+	btVector3 min = triangles[0][0], max = triangles[0][0];
+	for(const Polygon& triangle : triangles)
+		for(const btVector3& p : triangle) {
+			min.setMin(p);
+			max.setMax(p);
+		}
+
+	DistanceField field(triangles, min, max, settings.resolution, settings.concavity);
+
+	std::vector<Part> parts = connectedParts(triangles), finished;
+	for(Part& part : parts)
+		measure(part, field);
+
+	// keep splitting the part furthest from convex
+	while(!parts.empty() && int(parts.size() + finished.size()) < settings.maxHulls) {
+		auto worst = std::max_element(parts.begin(), parts.end(),
+			[](const Part& a, const Part& b) { return a.concavity < b.concavity; });
+
+		if(worst->concavity <= settings.concavity)
+			break;
+
+		Part below, above;
+		if(!split(*worst, field, below, above)) {
+			// too small to split any further
+			finished.push_back(std::move(*worst));
+			parts.erase(worst);
+			continue;
+		}
+
+		*worst = std::move(below);
+		parts.push_back(std::move(above));
+	}
+
+	ConvexHulls hulls;
+	for(const std::vector<Part>* list : {&parts, &finished})
+		for(const Part& part : *list)
+			if(!part.hull.empty())
+				hulls.push_back(part.hull);
+
+	return hulls;
+}
+
+btCollisionShape* ConvexDecomposition::createShape(const ConvexHulls& hulls, btScalar margin)
+{
+	std::vector<btConvexHullShape*> pieces;
+
+	for(const std::vector<btVector3>& hull : hulls) {
+		if(hull.empty())
+			continue;
+
+		// move the faces inwards by the margin bullet adds back around the hull
+		btConvexHullComputer computer;
+		computer.compute(&hull[0].getX(), sizeof(btVector3), int(hull.size()), margin, 0.25f);
+
+		btConvexHullShape *piece = computer.vertices.size() > 0
+			? new btConvexHullShape(&computer.vertices[0].getX(), computer.vertices.size(), sizeof(btVector3))
+			: new btConvexHullShape(&hull[0].getX(), hull.size(), sizeof(btVector3));
+		piece->setMargin(margin);
+		pieces.push_back(piece);
+	}
+
+	if(pieces.size() == 1)
+		return pieces[0];
+
+	// children keep model coordinates so no offsets are needed
+	btCompoundShape *compound = new btCompoundShape();
+	for(btConvexHullShape *piece : pieces)
+		compound->addChildShape(btTransform::getIdentity(), piece);
+
+	return compound;
+}
+
+void ConvexDecomposition::deleteShape(btCollisionShape *shape)
+{
+	if(shape && shape->isCompound()) {
+		btCompoundShape *compound = static_cast<btCompoundShape*>(shape);
+		for(int i = 0; i < compound->getNumChildShapes(); i++)
+			delete compound->getChildShape(i);
+	}
+
+	delete shape;
+}
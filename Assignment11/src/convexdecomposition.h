@@ -0,0 +1,56 @@
+#ifndef CONVEX_DECOMPOSITION_H
+#define CONVEX_DECOMPOSITION_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <btBulletDynamicsCommon.h>
+
+#include <vector>
+
+#include "meshdata.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// convex pieces approximating a model, each stored as the vertices of its hull
+typedef std::vector<std::vector<btVector3>> ConvexHulls;
+
+// splits a model into convex hulls used as a cheap collision proxy
+class ConvexDecomposition
+{
+public:
+	// tuning of the decomposition
+	struct Settings
+	{
+		Settings();
+
+		// largest gap allowed between a hull and the model surface, in model units
+		float concavity;
+
+		// voxels along the longest side of the model used to measure gaps
+		int resolution;
+
+		// upper bound on the number of hulls
+		int maxHulls;
+	};
+
+	// split every connected part of the mesh along axis planes until each
+	// piece's hull stays within the concavity of the surface
+	static ConvexHulls decompose(const MeshData& mesh, const Settings& settings = Settings());
+
+	// build a collision shape from hulls, a compound unless there is a single hull,
+	// hulls are shrunk by the margin so the collision surface matches the model
+	static btCollisionShape* createShape(const ConvexHulls& hulls, btScalar margin = 0.02f);
+
+	// delete a shape made by createShape together with its children
+	static void deleteShape(btCollisionShape *shape);
+};
+
+#endif // CONVEX_DECOMPOSITION_H
@@ -0,0 +1,153 @@
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "convexdecomposition.h"
+#include "hullcache.h"
+#include "physicsasset.h"
+#include "geometryloader.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// physics step time of one collision representation
+struct StepTime
+{
+	double average, worst;
+};
+
+// roll a ball over a tilting model like the game does and time every step
+StepTime measureSteps(const std::string& modelFile, const std::string& ballFile, int steps, bool hulls)
+{
+	PhysicsAsset::collisionHulls = hulls;
+	PhysicsAsset model(modelFile), ball(ballFile);
+
+	// same world setup as the engine
+	btDbvtBroadphase broadphase;
+	btDefaultCollisionConfiguration collisionConfig;
+	btCollisionDispatcher dispatcher(&collisionConfig);
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &collisionConfig);
+	world.setGravity(btVector3(0,-50,0));
+	btGImpactCollisionAlgorithm::registerAlgorithm(&dispatcher);
+
+	btDefaultMotionState modelState(btTransform(btQuaternion(0,0,0,1), btVector3(0,0,0)));
+	btRigidBody modelBody(0, &modelState, model.getShape());
+	modelBody.setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
+	modelBody.setActivationState(DISABLE_DEACTIVATION);
+	world.addRigidBody(&modelBody);
+
+	btVector3 inertia(0,0,0);
+	ball.getShape()->calculateLocalInertia(1, inertia);
+	btDefaultMotionState ballState(btTransform(btQuaternion(0,0,0,1), btVector3(0,0.1,0)));
+	btRigidBody::btRigidBodyConstructionInfo ballInfo(1, &ballState, ball.getShape(), inertia);
+	ballInfo.m_friction = 0.5;
+	btRigidBody ballBody(ballInfo);
+	ballBody.setActivationState(DISABLE_DEACTIVATION);
+	world.addRigidBody(&ballBody);
+
+	StepTime time = {0, 0};
+	for(int i = 0; i < steps; i++) {
+		// sweep the tilt through the range the keyboard allows
+		float t = i / 60.0f;
+		btTransform trans(btQuaternion(btVector3(0,0,1), 0.3f * std::sin(t * 0.7f))
+			* btQuaternion(btVector3(1,0,0), 0.3f * std::sin(t * 1.1f)));
+		modelState.setWorldTransform(trans);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		world.stepSimulation(1.0f / 60.0f);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		double ms = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end-start).count();
+		time.average += ms / steps;
+		time.worst = std::max(time.worst, ms);
+	}
+
+	world.removeRigidBody(&ballBody);
+	world.removeRigidBody(&modelBody);
+	return time;
+}
+
+// program start
+int main(int argc, char **argv)
+{
+	ConvexDecomposition::Settings settings;
+	std::vector<std::string> models;
+	std::string ballFile;
+	int steps = 3000;
+
+	// parse command line options, everything else is a model file
+	for(int i = 1; i < argc; i++) {
+		std::string option(argv[i]);
+
+		if(option == "--concavity" && i+1 < argc)
+			settings.concavity = std::atof(argv[++i]);
+		else if(option == "--resolution" && i+1 < argc)
+			settings.resolution = std::atoi(argv[++i]);
+		else if(option == "--max-hulls" && i+1 < argc)
+			settings.maxHulls = std::atoi(argv[++i]);
+		else if(option == "--compare" && i+1 < argc)
+			ballFile = argv[++i];
+		else if(option == "--steps" && i+1 < argc)
+			steps = std::atoi(argv[++i]);
+		else
+			models.push_back(option);
+	}
+
+	if(models.empty()) {
+		std::cerr << "Usage: " << argv[0] << " model.obj... [--concavity D] [--resolution N]"
+				  << " [--max-hulls N] [--compare ball.obj] [--steps N]" << std::endl;
+		return 1;
+	}
+
+	// build and store hulls for every model
+	for(const std::string& model : models) {
+		GeometryLoader loader(model.c_str());
+		MeshData data;
+		loader.load(data);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		ConvexHulls hulls = ConvexDecomposition::decompose(data, settings);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		size_t vertexCount = 0;
+		for(const std::vector<btVector3>& hull : hulls)
+			vertexCount += hull.size();
+
+		std::cout << model << ": " << data.triangleCount << " triangles -> " << hulls.size()
+				  << " hulls with " << vertexCount << " vertices in "
+				  << std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(end-start).count()
+				  << " ms" << std::endl;
+
+		if(!HullCache::write(model, hulls, settings))
+			return 1;
+	}
+
+	// compare physics step time of the first model against its render triangles
+	if(!ballFile.empty()) {
+		StepTime triangles = measureSteps(models[0], ballFile, steps, false);
+		StepTime hulls = measureSteps(models[0], ballFile, steps, true);
+
+		std::cout << "Step time over " << steps << " steps (average / worst):" << std::endl
+				  << "  triangles: " << triangles.average << " / " << triangles.worst << " ms" << std::endl
+				  << "  hulls:     " << hulls.average << " / " << hulls.worst << " ms" << std::endl
+				  << "  speedup:   " << triangles.average / hulls.average << "x" << std::endl;
+	}
+
+	return 0;
+}
@@ -14,52 +14,193 @@ enum MENU_ITEMS {
 int Engine::width = 1280, Engine::height = 720;
 ShaderLoader Engine::vertexShader(GL_VERTEX_SHADER),
 			Engine::fragmentShader(GL_FRAGMENT_SHADER);
-bool Engine::paused = false, Engine::initialized = false;
+std::atomic<bool> Engine::paused(false);
+bool Engine::initialized = false;
 bool Engine::ambient = true, Engine::specular = true, Engine::diffuse = true;
 std::string Engine::vertexFile("shaders/vert.vs"),
 			Engine::fragmentFile("shaders/frag.fs");
+std::string Engine::textVertexFile("shaders/text.vs"),
+			Engine::textFragmentFile("shaders/text.fs");
 float Engine::zoom = -10.0f;
 std::chrono::time_point<std::chrono::high_resolution_clock> Engine::t1, Engine::t2;
 std::vector<SimObject*> Engine::objects;
 glm::mat4 Engine::view;
 glm::mat4 Engine::projection;
+glm::mat4 Engine::viewProjection;
+glm::mat3 Engine::normalViewProjection;
+bool Engine::uniformRingEnabled = true;
+UniformRing *Engine::uniformRing = nullptr;
 GLuint Engine::program;
 bool Engine::keyStates[256], Engine::keyStatesSpecial[256];
 bool Engine::rightClick = false, Engine::leftClick = false, Engine::defaultCam = true;
 float Engine::mouseX, Engine::mouseY, Engine::posX = 0, Engine::posY = 0, Engine::distance = 20, Engine::posZ = -5;
-float Engine::boardAngle = 0, Engine::boardAngle2 = 0;
 std::vector<Light*> Engine::lights;
-float Engine::gameTime = 0.0f;
-int Engine::gameScore = 0;
-std::vector<std::string> Engine::topTenScores(10);
-
-btDiscreteDynamicsWorld* Engine::simulation = nullptr;
-btRigidBody *Engine::body1 = nullptr, *Engine::body2 = nullptr;
+LightArray *Engine::lightArray = nullptr;
+int Engine::lightCount = 2;
+float Engine::frameTime = 0.0f;
+std::chrono::time_point<std::chrono::high_resolution_clock> Engine::lastFrame;
+RenderQueue Engine::renderQueue;
+int Engine::ballCount = 0;
+bool Engine::instancing = true;
+std::vector<SimObject*> Engine::balls;
+InstanceBatch *Engine::ballBatch = nullptr;
+FrustumCuller Engine::culler;
+TextRenderer *Engine::hud = nullptr;
+int Engine::textSlot = 0;
+Profiler *Engine::profiler = nullptr;
+bool Engine::showProfiler = false;
+std::vector<std::string> Engine::debugText, Engine::profilerText, Engine::rankLabels;
+std::chrono::time_point<std::chrono::high_resolution_clock> Engine::debugRefresh;
+const int Engine::DEBUG_REFRESH_MS;
+unsigned long Engine::steps = 0, Engine::profiledStep = 0;
+int Engine::benchmarkFrames = 0;
+int Engine::simulationRate = 120;
+float Engine::accumulator = 0.0f;
+HeadlessContext *Engine::headless = nullptr;
+InputRecorder *Engine::recorder = nullptr;
+InputReplay *Engine::replay = nullptr;
+unsigned long Engine::replayMismatches = 0;
+bool Engine::threaded = true;
+std::thread Engine::simThread;
+std::atomic<bool> Engine::running(false);
+InputQueue Engine::input;
+SnapshotBuffer Engine::snapshots;
+Labyrinth *Engine::labyrinth = nullptr;
 
 void Engine::init(int argc, char **argv)
 {
+	// benchmarks run without a window, so look for them before glut needs a display
+	for(int i = 1; i+1 < argc; i++) {
+		if(std::string(argv[i]) == "--benchmark")
+			benchmarkFrames = std::max(1, std::atoi(argv[i+1]));
+	}
+
 	// init glut
-	glutInit(&argc, argv);
-	glutInitDisplayMode(GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGBA);
-	glutInitWindowSize(width,height);
-	glutCreateWindow("Labyrinth");
-
-	// set up glut callbacks
-	glutDisplayFunc(render);
-	glutReshapeFunc(reshape);
-	glutIdleFunc(update);
-	glutKeyboardFunc(keyboard);
-	glutKeyboardUpFunc(keyboardUp);
-	glutSpecialFunc(keyboardSpecial);
-	glutSpecialUpFunc(keyboardSpecialUp);
-	glutMouseFunc(mouse);
-	glutMotionFunc(mouseMovement);
-
-	// create popup menu
-	createMenus();
-
-	// initialize GLEW
-    GLenum status = glewInit();
+	if(!benchmarkFrames)
+		glutInit(&argc, argv);
+
+	// parse command line options left over by glut
+	std::string recordFile, replayFile;
+	for(int i = 1; i < argc; i++) {
+		std::string option(argv[i]);
+
+		// draw non-indexed triangle lists like before
+		if(option == "--flat-geometry")
+			GeometryLoader::indexedGeometry = false;
+
+		// ignore mesh cache files and rebuild them from the models
+		else if(option == "--rebuild-cache")
+			MeshCache::rebuild = true;
+
+		// set anisotropic texture filtering level
+		else if(option == "--anisotropy" && i+1 < argc)
+			ModelLoader::anisotropy = std::atof(argv[++i]);
+
+		// set number of detail levels generated for each model
+		else if(option == "--lod-levels" && i+1 < argc)
+			GeometryLoader::lodLevels = std::max(1, std::atoi(argv[++i]));
+
+		// collide against convex hulls instead of the render triangles
+		else if(option == "--collision-hulls")
+			PhysicsAsset::collisionHulls = true;
+
+		// load serialized collision shapes instead of building them
+		else if(option == "--shape-cache")
+			PhysicsAsset::serializedShapes = true;
+
+		// spawn extra balls for load testing
+		else if(option == "--balls" && i+1 < argc)
+			ballCount = std::max(0, std::atoi(argv[++i]));
+
+		// step physics on Bullet's multithreaded world
+		else if(option == "--physics-threads" && i+1 < argc)
+			Labyrinth::physicsThreads = std::max(0, std::atoi(argv[++i]));
+
+		// set number of lights, one follows the ball
+		else if(option == "--lights" && i+1 < argc)
+			lightCount = std::min(std::max(1, std::atoi(argv[++i])), int(LightArray::MAX_LIGHTS));
+
+		// pass object matrices as uniforms instead of through the uniform ring
+		else if(option == "--no-uniform-ring")
+			uniformRingEnabled = false;
+
+		// draw extra balls one by one instead of instanced
+		else if(option == "--no-instancing")
+			instancing = false;
+
+		// step the simulation between frames instead of on its own thread
+		else if(option == "--single-thread")
+			threaded = false;
+
+		// set fixed simulation steps per second
+		else if(option == "--hz" && i+1 < argc)
+			simulationRate = std::max(1, std::atoi(argv[++i]));
+
+		// write all input to a file
+		else if(option == "--record" && i+1 < argc)
+			recordFile = argv[++i];
+
+		// play the input of a recording instead of the player's
+		else if(option == "--replay" && i+1 < argc)
+			replayFile = argv[++i];
+
+		// frame count of the benchmark, read before glut
+		else if(option == "--benchmark" && i+1 < argc)
+			i++;
+
+		else
+			std::cerr << "Unknown option: " << option << std::endl;
+	}
+
+	// replays run with the settings they were recorded with
+	if(!replayFile.empty()) {
+		replay = new InputReplay(replayFile);
+		const RecordingSettings& settings = replay->getSettings();
+		simulationRate = settings.simulationRate;
+		ballCount = settings.ballCount;
+		PhysicsAsset::collisionHulls = settings.collisionHulls;
+		PhysicsAsset::serializedShapes = settings.serializedShapes;
+		std::cout << "Replay: " << replay->getStepCount() << " steps at " << simulationRate << " Hz" << std::endl;
+	}
+
+	if(!recordFile.empty()) {
+		recorder = new InputRecorder(recordFile, RecordingSettings{uint32_t(simulationRate), uint32_t(ballCount),
+				PhysicsAsset::collisionHulls, PhysicsAsset::serializedShapes});
+	}
+
+	// benchmarks draw offscreen and step the simulation once per frame
+	if(benchmarkFrames) {
+		headless = new HeadlessContext();
+		threaded = false;
+	}
+
+	else {
+		glutInitDisplayMode(GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGBA);
+		glutInitWindowSize(width,height);
+		glutCreateWindow("Labyrinth");
+
+		// return from the main loop when the window closes so the simulation thread can stop
+		#ifndef __APPLE__
+			glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+		#endif
+
+		// set up glut callbacks
+		glutDisplayFunc(render);
+		glutReshapeFunc(reshape);
+		glutIdleFunc(update);
+		glutKeyboardFunc(keyboard);
+		glutKeyboardUpFunc(keyboardUp);
+		glutSpecialFunc(keyboardSpecial);
+		glutSpecialUpFunc(keyboardSpecialUp);
+		glutMouseFunc(mouse);
+		glutMotionFunc(mouseMovement);
+
+		// create popup menu
+		createMenus();
+	}
+
+	// initialize GLEW, without a window only the context functions as there is no GLX display
+    GLenum status = headless ? glewContextInit() : glewInit();
     if( status != GLEW_OK)
     {
         std::cerr << "[F] GLEW NOT INITIALIZED: ";
@@ -67,6 +208,12 @@ void Engine::init(int argc, char **argv)
         throw std::runtime_error("GLEW initialization failed!");
     }
 
+    // draw into a framebuffer the size of the window
+    if(headless) {
+        headless->createFramebuffer(width, height);
+        std::cout << "Benchmark: " << benchmarkFrames << " frames on " << headless->getRenderer() << std::endl;
+    }
+
     // init OpenGL functions
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LESS);
@@ -80,41 +227,92 @@ void Engine::init(int argc, char **argv)
 	// init projection matrix
 	projection = glm::perspective(45.0f, float(width)/float(height), 0.01f, 100.0f);
 
-	// initialize physics engine
-	initPhysics();
+    // object matrices come from a uniform block if the context has everything the ring needs
+    bool uniformBlocks = uniformRingEnabled && UniformRing::supported();
+    std::string vertexHeader = uniformBlocks ? "#version 120\n#define UNIFORM_BLOCKS\n" : "";
 
     // load shaders
-    if(!vertexShader.load(vertexFile) || !fragmentShader.load(fragmentFile))
+    if(!vertexShader.load(vertexFile, vertexHeader) || !fragmentShader.load(fragmentFile))
         return;
 
     // link shaders
     program = ShaderLoader::linkShaders({vertexShader, fragmentShader});
 
-    // create board and ball
-    objects.push_back(new SimObject(program, 0, "board.obj", btVector3(0,0,0)));
-	objects.push_back(new SimObject(program, 1, "ball.obj", btVector3(0,0.1,0)));
-	objects.push_back(new SimObject(program, 0, "boardTop.obj", btVector3(0,0.1,0)));
+    // one block per object, extra ball and the ball batch each frame
+    if(uniformBlocks) {
+        glUniformBlockBinding(program, glGetUniformBlockIndex(program, "ObjectMatrices"), ObjectUniforms::BINDING);
+        uniformRing = new UniformRing(sizeof(ObjectUniforms), 3 + ballCount + 1);
+    }
 
-	// set up board as kinematic object
-	objects[0]->getMesh()->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
-	objects[2]->getMesh()->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
+    // draw HUD text from a glyph atlas, or with GLUT bitmaps if the context can't build one
+    ShaderLoader textVertexShader(GL_VERTEX_SHADER), textFragmentShader(GL_FRAGMENT_SHADER);
+    if(!headless && TextRenderer::supported() && textVertexShader.load(textVertexFile) && textFragmentShader.load(textFragmentFile))
+        hud = new TextRenderer(ShaderLoader::linkShaders({textVertexShader, textFragmentShader}));
+
+    // time parts of each frame, on the GPU too if the context has timer queries
+    profiler = new Profiler();
+
+    // time model loading to compare cold and warm mesh caches
+    auto loadStart = std::chrono::high_resolution_clock::now();
+
+    // import models, decode textures and build collision shapes on worker threads
+    AssetRegistry::preload({"board.obj", "ball.obj", "boardTop.obj"});
+
+    // build the game from the shared shapes, uploading each model once its worker finishes
+    LabyrinthAssets assets;
+    assets.board = AssetRegistry::acquireMesh("board.obj");
+    assets.ball = AssetRegistry::acquireMesh("ball.obj");
+    assets.cover = AssetRegistry::acquireMesh("boardTop.obj");
+    labyrinth = new Labyrinth(assets, ballCount);
+
+    // draw board, ball and cover where their bodies start
+    const std::vector<PhysicsBody*>& bodies = labyrinth->getBodies();
+    objects.push_back(new SimObject(program, "board.obj", bodies[0]->getWorldMatrix()));
+	objects.push_back(new SimObject(program, "ball.obj", bodies[1]->getWorldMatrix()));
+	objects.push_back(new SimObject(program, "boardTop.obj", bodies[2]->getWorldMatrix()));
+
+	// output startup time of models
+	auto loadEnd = std::chrono::high_resolution_clock::now();
+	std::cout << "Startup: " << objects.size() << " models loaded in "
+			  << std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(loadEnd-loadStart).count()
+			  << " ms" << (MeshCache::rebuild ? " (cache rebuilt)" : "") << std::endl;
+
+	// extra balls follow the board, ball and cover
+	for(size_t i = Labyrinth::OBJECT_COUNT; i < bodies.size(); i++) {
+		balls.push_back(new SimObject(program, "ball.obj", bodies[i]->getWorldMatrix()));
+	}
 
-	// add objects to the simulation enviornment
-	for(SimObject *object : objects) {
-		simulation->addRigidBody(object->getMesh());
+	// draw them with one call if the context allows it
+	if(!balls.empty() && instancing && InstanceBatch::supported())
+		ballBatch = new InstanceBatch(program, balls);
+	// cull board, ball and extra balls, the cover is never drawn
+	culler.add(objects[0]);
+	culler.add(objects[1]);
+	for(SimObject *ball : balls) {
+		culler.add(ball);
 	}
 
-	// create lights
-	lights.push_back(new Light(program, glm::vec3(0,5,0)));
-	lights.push_back(new Light(program, glm::vec3(0,1,0)));
+	if(!balls.empty())
+		std::cout << "Balls: " << balls.size() << (ballBatch ? " instanced" : " drawn one by one") << std::endl;
 
-	lights[1]->enableTracking(objects[1]);
+	// create a light following the ball and one above the board
+	lights.push_back(new Light(glm::vec3(0,1,0)));
+	lights[0]->enableTracking(objects[1]);
+	if(lightCount > 1)
+		lights.push_back(new Light(glm::vec3(0,5,0)));
 
-	// initialize top scores
-	for(int i = 1; i <= 10; i++) {
-			topTenScores[i-1] = std::string("Time: 0.00   Fail Count: 0");
+	// spread any further lights on a ring over the board
+	for(int i = 2; i < lightCount; i++) {
+		float angle = 2.0f * float(M_PI) * (i - 2) / (lightCount - 2);
+		lights.push_back(new Light(glm::vec3(8.0f * std::cos(angle), 3.0f, 8.0f * std::sin(angle))));
 	}
 
+	// all lights reach the shader in one array
+	lightArray = new LightArray(program);
+
+	// the first frame draws the starting state
+	publishSnapshot();
+
 	// set initialized flag to true
 	initialized = true;
 }
@@ -125,21 +323,105 @@ int Engine::run()
 	if(!initialized)
 		throw std::runtime_error("Engine::init() must be called first!");
 
-	// initialize clock
-	t1 = std::chrono::high_resolution_clock::now();
+	// initialize clocks
+	t1 = lastFrame = std::chrono::high_resolution_clock::now();
+
+	// play the scripted run instead of the game
+	if(benchmarkFrames)
+		return runBenchmark();
+
+	// simulate next to the render loop
+	if(threaded) {
+		running = true;
+		simThread = std::thread(simulate);
+	}
 
 	// enter glut main event loop
 	glutMainLoop();
 
-	// clean up objects
+	// clean up objects once the simulation no longer uses them
+	stopSimulation();
+	cleanUp();
+
+	return 0;
+}
+
+int Engine::runBenchmark()
+{
+	// frames left out of the summary while caches and the driver warm up
+	const int warmup = std::min(10, benchmarkFrames / 10);
+
+	std::vector<float> simTimes(benchmarkFrames), renderTimes(benchmarkFrames);
+	profiler->enableFrameLog();
+
+	for(int frame = 0; frame < benchmarkFrames; frame++) {
+		benchmarkScript(frame);
+
+		{
+			CpuTimer timer(simTimes[frame]);
+			simulateStep();
+		}
+
+		{
+			CpuTimer timer(renderTimes[frame]);
+			render();
+		}
+	}
+
+	// GPU times of the last frames
+	profiler->finish();
+
+	// per frame times as CSV
+	std::vector<float> gpuTimes;
+	std::cout << "frame,sim_ms,render_ms,gpu_ms" << std::endl;
+	for(int frame = 0; frame < benchmarkFrames; frame++) {
+		float gpu = profiler->getFrameTime(Profiler::GPU_SCENE, frame);
+		std::cout << frame << "," << simTimes[frame] << "," << renderTimes[frame] << "," << gpu << std::endl;
+		if(frame >= warmup && gpu >= 0.0f)
+			gpuTimes.push_back(gpu);
+	}
+
+	// summary after warm up
+	auto summary = [](const char *name, const std::vector<float>& times) {
+		Profiler::Stats stats = Profiler::computeStats(times);
+		std::cout << name << ": min " << stats.min << " ms, avg " << stats.avg << " ms, p99 " << stats.p99 << " ms" << std::endl;
+	};
+	std::cout << "Summary of " << benchmarkFrames - warmup << " frames after " << warmup << " warm up frames" << std::endl;
+	summary("Simulation", std::vector<float>(simTimes.begin() + warmup, simTimes.end()));
+	summary("Render CPU", std::vector<float>(renderTimes.begin() + warmup, renderTimes.end()));
+	summary("Render GPU", gpuTimes);
+
+	// the context has to outlive everything drawn with it
 	cleanUp();
+	delete headless;
 
 	return 0;
 }
 
+void Engine::benchmarkScript(int frame)
+{
+	// circle the board once over the whole run
+	float angle = 2.0f * float(M_PI) * frame / benchmarkFrames;
+	view = glm::lookAt(glm::vec3(distance * sin(angle),distance,distance * cos(angle)),
+					   glm::vec3(0,0,0),
+					   glm::vec3(0,1,0));
+
+	// sway the board so the ball keeps rolling, through the same input as the mouse
+	auto tilt = [](int frame) {
+		float t = frame / 60.0f;
+		return glm::vec2(0.2f * std::sin(t), 0.2f * std::sin(0.7f * t));
+	};
+	glm::vec2 change = tilt(frame) - tilt(std::max(0, frame - 1));
+	input.push(InputEvent{InputEvent::TILT, 0, change.x, change.y});
+}
+
 void Engine::cleanUp()
 {
 	// delete all simulation objects
+	delete ballBatch;
+	for(SimObject* ball : balls) {
+		delete ball;
+	}
 	for(SimObject* object : objects) {
 		delete object;
 	}
@@ -148,10 +430,21 @@ void Engine::cleanUp()
 	for(Light *light : lights) {
 		delete light;
 	}
+	delete lightArray;
+	delete hud;
+	delete profiler;
+	delete recorder;
+	delete replay;
+	delete uniformRing;
+	delete labyrinth;
 }
 
 float Engine::getDT()
 {
+	// benchmarks simulate the same time every run
+	if(benchmarkFrames)
+		return 1.0f / 60.0f;
+
 	// get difference in time between ticks
 	t2 = std::chrono::high_resolution_clock::now();
 	float ret = std::chrono::duration_cast<std::chrono::duration<float>>(t2-t1).count();
@@ -159,24 +452,34 @@ float Engine::getDT()
 	return ret;
 }
 
-glm::mat4 Engine::getView()
+const glm::mat4& Engine::getView()
 {
 	return view;
 }
 
-glm::mat4 Engine::getProjection()
+const glm::mat4& Engine::getProjection()
 {
 	return projection;
 }
 
-void Engine::reset()
+const glm::mat4& Engine::getViewProjection()
+{
+	return viewProjection;
+}
+
+const glm::mat3& Engine::getNormalViewProjection()
+{
+	return normalViewProjection;
+}
+
+UniformRing* Engine::getUniformRing()
 {
-	// reset objects to inital positions
-	objects[0]->rotate(0,btVector3(1,1,1));
-	objects[2]->rotate(0,btVector3(1,1,1));
-	objects[1]->reset();
+	return uniformRing;
+}
 
-	boardAngle = boardAngle2 = 0;
+int Engine::getHeight()
+{
+	return height;
 }
 
 void Engine::render()
@@ -187,29 +490,140 @@ void Engine::render()
 	int i = 1;
 	float height = 0.68;
 	
+	// smooth time between frames so the HUD stays readable
+	auto now = std::chrono::high_resolution_clock::now();
+	float frameMs = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(now-lastFrame).count();
+	frameTime = frameTime * 0.95f + frameMs * 0.05f;
+	lastFrame = now;
+	profiler->record(Profiler::FRAME, frameMs);
+
+	// time the scene on the GPU from the clear to the last draw
+	profiler->beginGpu(Profiler::GPU_SCENE);
+
 	// init GL background color and clear buffer bits
 	glClearColor(0.0,0.5,0.5,1.0);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+	// count GL calls of this frame only
+	GLState::resetCounters();
+
+	// place objects where the newest simulation step left them
+	const Snapshot& snapshot = snapshots.read();
+	if(snapshot.transforms.size() == objects.size() + balls.size()) {
+		for(size_t i = 0; i < objects.size(); i++) {
+			objects[i]->setModel(snapshot.transforms[i]);
+		}
+		for(size_t i = 0; i < balls.size(); i++) {
+			balls[i]->setModel(snapshot.transforms[objects.size() + i]);
+		}
+	}
+
+	// simulation times of each new step
+	if(snapshot.step != profiledStep) {
+		profiler->record(Profiler::INPUT, snapshot.inputTime);
+		profiler->record(Profiler::PHYSICS, snapshot.physicsTime);
+		profiler->record(Profiler::OBJECTS, snapshot.objectTime);
+		profiledStep = snapshot.step;
+	}
+
+	// CPU times of the parts of this frame
+	float lightMs, cullMs, submitMs;
+
 	// use main shader program
-	glUseProgram(program);
+	GLState::useProgram(program);
+
+	// move and upload lights
+	{
+		CpuTimer timer(lightMs);
+
+		// move tracking lights along with their objects
+		for(Light *light : lights) {
+			light->update();
+		}
 
-	// render all objects
-	//for(SimObject* object : objects) {
-	//	object->render(ambient, specular, diffuse);
-	//}
-	// render everything except the cover
-	for(int i=0; i<2; i++) {
-		objects[i]->render(ambient,specular,diffuse);
+		// upload all lights, before the objects so they light this frame
+		lightArray->render(lights, ambient, specular, diffuse);
 	}
 
-	// render all lights
-	for(Light *light : lights) {
-		light->render(ambient, specular, diffuse);
+	// camera matrices are combined once per frame, normals of every object
+	// go through the same inverse transpose before their model rotation
+	viewProjection = projection * view;
+	normalViewProjection = glm::inverseTranspose(glm::mat3(viewProjection));
+
+	// mark objects inside the view
+	{
+		CpuTimer timer(cullMs);
+		culler.cull(viewProjection);
+	}
+
+	// submit and draw everything visible
+	{
+		CpuTimer timer(submitMs);
+
+		// object matrices of this frame go to the next section of the ring
+		if(uniformRing)
+			uniformRing->beginFrame();
+
+		// queue everything visible except the cover, then draw it sorted by state
+		renderQueue.clear();
+		for(int i=0; i<2; i++) {
+			if(objects[i]->isVisible())
+				objects[i]->submit(renderQueue);
+		}
+		if(ballBatch) {
+			ballBatch->submit(renderQueue);
+		}
+		else {
+			for(SimObject *ball : balls) {
+				if(ball->isVisible())
+					ball->submit(renderQueue);
+			}
+		}
+		renderQueue.execute();
+
+		if(uniformRing)
+			uniformRing->endFrame();
 	}
 
 	// disable main shader program
-    glUseProgram(0);
+    GLState::useProgram(0);
+    profiler->endGpu();
+
+    profiler->record(Profiler::LIGHTS, lightMs);
+    profiler->record(Profiler::CULLING, cullMs);
+    profiler->record(Profiler::SUBMIT, submitMs);
+
+    // text and overlay are timed together
+    auto hudStart = std::chrono::high_resolution_clock::now();
+
+    // debug lines change every frame, so their text is only rebuilt a few times a second
+    bool refreshDebug = hudStart - debugRefresh >= std::chrono::milliseconds(DEBUG_REFRESH_MS);
+    if(refreshDebug) {
+        debugRefresh = hudStart;
+        debugText.clear();
+
+        // GL call counts of the scene before the text adds its own
+        sprintf(textBuffer, "GL calls: %lu issued, %lu skipped",
+                GLState::getIssuedCalls(), GLState::getSkippedCalls());
+        debugText.push_back(textBuffer);
+
+        // number of draws the queue issued
+        sprintf(textBuffer, "Draw calls: %lu", (unsigned long)renderQueue.size());
+        debugText.push_back(textBuffer);
+
+        // frustum culling results
+        sprintf(textBuffer, "Visible: %d, culled: %d", culler.getVisibleCount(), culler.getCulledCount());
+        debugText.push_back(textBuffer);
+
+        // frame time and light count for comparing scenes
+        sprintf(textBuffer, "Frame: %.2f ms, lights: %d", frameTime, int(lights.size()));
+        debugText.push_back(textBuffer);
+    }
+
+    // render debug lines
+    for(size_t line = 0; line < debugText.size(); line++) {
+        renderText(debugText[line].c_str(), glm::vec2(-0.95,0.57 - 0.07*line), glm::vec3(0.0,0.0,0.0));
+    }
 
     // render specular light text
     std::string text = specular ? "Specular: On" : "Specular: Off";
@@ -228,107 +642,268 @@ void Engine::render()
     renderText(text.c_str(), glm::vec2(0.6, 0.92), glm::vec3(0.0,0.0,0.0));
 
     // fill buffer with value and render time text
-    sprintf(textBuffer, "Time: %.2f", gameTime);
+    sprintf(textBuffer, "Time: %.2f", snapshot.gameTime);
     renderText(textBuffer, glm::vec2(0.6,0.85), glm::vec3(0.0,0.0,0.0));
 
     // fill buffer with value and render game score
-    sprintf(textBuffer, "Fail Count: %d", gameScore);
+    sprintf(textBuffer, "Fail Count: %d", snapshot.gameScore);
     renderText(textBuffer, glm::vec2(0.8, 0.85), glm::vec3(0.0,0.0,0.0));
 
 	text = "Top Ten Scores";
 	renderText(text.c_str(), glm::vec2(0.6,0.75), glm::vec3(0.0,0.0,0.0));
 
+	// rank labels never change, so they're built once
+	while(rankLabels.size() < snapshot.topTenScores.size()) {
+		rankLabels.push_back(std::to_string(rankLabels.size() + 1) + ".");
+	}
+
 	// render top 10 scores
-	for(std::string scoreStr : topTenScores) {
-		sprintf(textBuffer, "%d.", i++);
-		renderText(textBuffer, glm::vec2(0.6,height), glm::vec3(0.0,0.0,0.0));
+	for(const std::string& scoreStr : snapshot.topTenScores) {
+		renderText(rankLabels[i++ - 1].c_str(), glm::vec2(0.6,height), glm::vec3(0.0,0.0,0.0));
 		renderText(scoreStr.c_str(), glm::vec2(0.64,height), glm::vec3(0.0,0.0,0.0));
 		height -= 0.07;
 	}
 
-    // draw to the screen
-	glutSwapBuffers();
+	// render rolling times of every part of the frame
+	// render rolling times of every part of the frame, refreshed with the debug lines
+	if(showProfiler) {
+		if(refreshDebug || profilerText.empty()) {
+			profilerText.clear();
+			for(int section = 0; section < Profiler::SECTION_COUNT; section++) {
+				Profiler::Stats stats = profiler->getStats(Profiler::Section(section));
+				sprintf(textBuffer, "%s: %.2f / %.2f / %.2f", Profiler::getName(Profiler::Section(section)),
+						stats.min, stats.avg, stats.p99);
+				profilerText.push_back(textBuffer);
+			}
+		}
+
+		float y = -0.02;
+		renderText("Profiler (min / avg / p99 ms)", glm::vec2(-0.95,y), glm::vec3(0.0,0.0,0.0));
+		for(const std::string& line : profilerText) {
+			y -= 0.06;
+			renderText(line.c_str(), glm::vec2(-0.95,y), glm::vec3(0.0,0.0,0.0));
+		}
+	}
+
+	profiler->beginGpu(Profiler::GPU_HUD);
+
+	// frame times under the profiler text, yellow for frames and green for the GPU scene
+	if(showProfiler)
+		profiler->renderGraph(glm::vec2(-0.95,-0.95), glm::vec2(-0.35,-0.70), 50.0f);
+
+	// draw all text slots filled this frame at once
+	if(hud) {
+		hud->truncate(textSlot);
+		hud->render(width, Engine::height);
+	}
+	textSlot = 0;
+
+	profiler->endGpu();
+	auto hudEnd = std::chrono::high_resolution_clock::now();
+	profiler->record(Profiler::HUD, std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(hudEnd-hudStart).count());
+
+	// queries of this frame are read back a few frames later
+	profiler->endFrame();
+
+    // draw to the screen, offscreen frames only need to reach the GPU
+    if(headless)
+        glFlush();
+    else
+        glutSwapBuffers();
 }
 
 void Engine::update()
 {
-	// if paused update clock tick and do nothing
-    if(paused) {
-        t1 = std::chrono::high_resolution_clock::now();
-        return;
-    }
+	// without a simulation thread step once per frame
+	if(!threaded)
+		simulateStep();
 
-    // get difference in time tick
-	float dt = getDT();
+	// trigger render event
+	glutPostRedisplay();
+}
 
-	// add change in time to game time
-	gameTime += dt;
+void Engine::simulate()
+{
+	// step as long as the window is open, the short sleep leaves the core to rendering
+	while(running) {
+		simulateStep();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
 
-	// trigger keyboard actions
-	keyboardHandle();
+void Engine::simulateStep()
+{
+	// the snapshot being filled carries the step times to the profiler
+	Snapshot& next = snapshots.write();
 
-	// step physics
-	simulation->stepSimulation(dt);
+	// apply everything the callbacks queued since the last step
+	InputEvent event;
+	{
+		CpuTimer timer(next.inputTime);
+		while(input.pop(event)) {
+			bool changesState = event.type != InputEvent::PAUSE && event.type != InputEvent::RESUME;
 
-	// update all objects
-	for(SimObject *object : objects) {
-		object->update();
+			// replays take nothing but pausing from the player
+			if(replay && changesState)
+				continue;
+
+			// recordings keep what changes the simulation, at the step it goes in before
+			if(recorder && changesState && !(paused && event.type == InputEvent::TILT))
+				recorder->addEvent(steps, event);
+
+			handleInput(event);
+		}
 	}
 
-	// update all lights
-	for(Light *light : lights) {
-		light->update();
+	next.physicsTime = next.objectTime = 0.0f;
+
+	// if paused update clock tick and do nothing
+	if(paused) {
+		t1 = std::chrono::high_resolution_clock::now();
 	}
+	else {
+		// get difference in time tick and simulate it in fixed steps
+		const float step = 1.0f / simulationRate;
+		accumulator += getDT();
+
+		int substeps = 0;
+		while(accumulator >= step && substeps < MAX_SUBSTEPS) {
+			// recorded input goes in before the step it was given for
+			const StepRecord *replayed = replay ? replay->getStep(steps) : nullptr;
+			if(replayed) {
+				while(replay->nextEvent(steps, event)) {
+					handleInput(event);
+				}
+			}
 
-	// trigger render event
-	glutPostRedisplay();
+			// trigger keyboard actions and step physics
+			float ms;
+			{
+				CpuTimer timer(ms);
+
+				// replays set the board exactly as recorded
+				if(replayed) {
+					labyrinth->setBoardAngles(replayed->boardAngle, replayed->boardAngle2);
+					labyrinth->stepPhysics(step, 0.0f, 0.0f);
+				}
+				else {
+					glm::vec2 tilt = keyboardHandle();
+					labyrinth->stepPhysics(step, tilt.x, tilt.y);
+				}
+			}
+			next.physicsTime += ms;
+
+			// the angles the step used, scoring resets them on a goal
+			float boardAngle = labyrinth->getBoardAngle(), boardAngle2 = labyrinth->getBoardAngle2();
+
+			// score and reset fallen balls, adding the step to game time
+			{
+				CpuTimer timer(ms);
+				labyrinth->applyRules(step);
+			}
+			next.objectTime += ms;
+
+			accumulator -= step;
+			substeps++;
+
+			// keep the angles the step used or compare the state it ended in
+			if(recorder || replayed) {
+				StepRecord record{boardAngle, boardAngle2, labyrinth->checksum()};
+				if(recorder)
+					recorder->addStep(record);
+				if(replayed && record.checksum != replayed->checksum && replayMismatches++ == 0)
+					std::cout << "Replay diverged at step " << steps << std::endl;
+			}
+			steps++;
+
+			// hand control back to the player once the recording ends
+			if(replay && !replay->getStep(steps)) {
+				std::cout << "Replay finished: " << replay->getStepCount() << " steps, "
+						  << replayMismatches << " with a different state" << std::endl;
+				delete replay;
+				replay = nullptr;
+			}
+		}
+
+		// too far behind, let the game slow down rather than fall further back
+		if(substeps == MAX_SUBSTEPS)
+			accumulator = std::min(accumulator, step);
+	}
+
+	// hand the new state to the renderer
+	publishSnapshot();
 }
 
-void Engine::score(int x)
+void Engine::publishSnapshot()
 {
-	if(x == 0) gameScore++;
-	if(x == 1) {
-		// comparator function for sorting scores
-		auto scoreCmp = [](const std::string& str1, const std::string& str2) -> float {
-			std::stringstream ss(str1);
-			std::string timeText;
-			float t1, t2;
-
-			ss >> timeText >> t1;
-			ss.str(str2);
-			ss >> timeText >> t2;
+	Snapshot& snapshot = snapshots.write();
+	const std::vector<PhysicsBody*>& bodies = labyrinth->getBodies();
+	snapshot.transforms.resize(bodies.size());
+	// part of the next step that has passed, drawn between the last two steps
+	float alpha = std::min(accumulator * simulationRate, 1.0f);
+	for(size_t i = 0; i < bodies.size(); i++) {
+		snapshot.transforms[i] = bodies[i]->getWorldMatrix(alpha);
+	}
+	snapshot.gameTime = labyrinth->getGameTime();
+	snapshot.gameScore = labyrinth->getGameScore();
+	snapshot.topTenScores = labyrinth->getTopTenScores();
+	snapshot.step = steps;
+	snapshots.publish();
+}
 
-			if(t1 == 0.0 && t2 != 0.0)
-				return t2 < t1;
+void Engine::stopSimulation()
+{
+	// wait for the current step to finish
+	running = false;
+	if(simThread.joinable())
+		simThread.join();
+}
 
-			if (t1 != 0.0 && t2 == 0.0)
-				return t1 > t2;
+void Engine::handleInput(const InputEvent& event)
+{
+	switch(event.type) {
+		// track held keys for keyboardHandle
+		case InputEvent::KEY_DOWN:
+			keyStates[event.key] = true;
+		break;
 
-			else
-				return t1 < t2;
-		};
+		case InputEvent::KEY_UP:
+			keyStates[event.key] = false;
+		break;
 
-		// buffer for score text
-		char buffer[256];
+		case InputEvent::SPECIAL_DOWN:
+			keyStatesSpecial[event.key] = true;
+		break;
 
-		// load buffer with current values
-		sprintf(buffer, "Time: %.2f   Fail Count: %d", gameTime, gameScore);
+		case InputEvent::SPECIAL_UP:
+			keyStatesSpecial[event.key] = false;
+		break;
 
-		// add score to top ten
-		topTenScores.push_back(std::string(buffer));
+		// board dragged with the mouse
+		case InputEvent::TILT:
+			if(!paused)
+				labyrinth->tiltBoard(event.angle, event.angle2);
+		break;
 
-		// sort scores
-		std::sort(topTenScores.begin(), topTenScores.end(), scoreCmp);
+		// finish the current game
+		case InputEvent::FINISH:
+			labyrinth->finish();
+		break;
 
-		// remove 11th score
-		topTenScores.pop_back();
+		// pause simulation
+		case InputEvent::PAUSE:
+			paused = true;
+		break;
 
-		// reset game values
-		gameTime = 0.0;
-		gameScore = 0;
+		// resume simulation
+		case InputEvent::RESUME:
+			paused = false;
+		break;
 
-		// reset board and ball position
-		reset();
+		// restart game
+		case InputEvent::RESTART:
+			labyrinth->restart();
+		break;
 	}
 }
 
@@ -347,11 +922,21 @@ void Engine::reshape(int new_width, int new_height)
 
 void Engine::keyboard(unsigned char key, int x_pos, int y_pos)
 {
-	// set state of keypress to true
-    keyStates[int(key)] = true;
+	// hand the keypress to the simulation
+	input.push(InputEvent{InputEvent::KEY_DOWN, int(key), 0.0f, 0.0f});
 
     // special key cases
     switch(key) {
+    	// if Escape pressed quit
+    	case ESC:
+		#ifndef __APPLE__
+		    glutLeaveMainLoop();
+		#else
+			stopSimulation();
+			exit(0);
+		#endif
+		break;
+
     	// toggle ambient light
         case 'a':
         case 'A':
@@ -372,8 +957,15 @@ void Engine::keyboard(unsigned char key, int x_pos, int y_pos)
 
         case 't':
         case 'T':
-        	score(1);
+        	input.push(InputEvent{InputEvent::FINISH, 0, 0.0f, 0.0f});
         break;
+
+        // toggle profiler overlay
+        case 'p':
+        case 'P':
+            showProfiler = !showProfiler;
+        break;
+
         // if space is pressed reset to default camera
 		case SPACE:
 			defaultCam = true;
@@ -386,74 +978,47 @@ void Engine::keyboard(unsigned char key, int x_pos, int y_pos)
 
 void Engine::keyboardSpecial(int key, int x_pos, int y_pos)
 {
-    keyStatesSpecial[key] = true;
+    input.push(InputEvent{InputEvent::SPECIAL_DOWN, key, 0.0f, 0.0f});
 }
 
 void Engine::keyboardUp(unsigned char key, int x_pos, int y_pos)
 {
-    keyStates[int(key)] = false;
+    input.push(InputEvent{InputEvent::KEY_UP, int(key), 0.0f, 0.0f});
 }
 
 void Engine::keyboardSpecialUp(int key, int x_pos, int y_pos)
 {
-    keyStatesSpecial[key] = false;
+    input.push(InputEvent{InputEvent::SPECIAL_UP, key, 0.0f, 0.0f});
 }
 
-void Engine::keyboardHandle()
+glm::vec2 Engine::keyboardHandle()
 {
-	// if Escape pressed quit
-    if(keyStates[ESC]) {
-	#ifndef __APPLE__
-	    glutLeaveMainLoop();
-	#else
-		exit(0);
-	#endif
-	}
-
 	// set keyboard mapping for precise controls
+	float angle = 0.0f, angle2 = 0.0f;
     if(keyStatesSpecial[GLUT_KEY_RIGHT]) {
-    	boardAngle -= 0.01;
+    	angle -= 0.01;
 
     }
 
     if(keyStatesSpecial[GLUT_KEY_LEFT]) {
-        boardAngle += 0.01;
+        angle += 0.01;
 
     }
 
     if(keyStatesSpecial[GLUT_KEY_UP]) {
-    	boardAngle2 -= 0.01;
+    	angle2 -= 0.01;
 
     }
 
     if(keyStatesSpecial[GLUT_KEY_DOWN]) {
-    	boardAngle2 += 0.01;
+    	angle2 += 0.01;
 
     }
 
-    // limit board rotation
-	if(boardAngle > 0.5) boardAngle = 0.5;
-	if(boardAngle < -0.5) boardAngle = -0.5;
-	if(boardAngle2 > 0.5) boardAngle2 = 0.5;
-	if(boardAngle2 < -0.5) boardAngle2 = -0.5;
-	
-	// update board with new rotation value
-    btTransform trans;
-    objects[0]->getMesh()->getMotionState()->getWorldTransform(trans);
-    auto rotation = trans.getRotation();
-    rotation += btQuaternion(btVector3(0,0,1), boardAngle) + btQuaternion(btVector3(1,0,0), boardAngle2);
-    trans.setRotation(rotation);
-    objects[0]->getMesh()->getMotionState()->setWorldTransform(trans);
-
-	objects[2]->getMesh()->getMotionState()->getWorldTransform(trans);
-    rotation = trans.getRotation();
-    rotation += btQuaternion(btVector3(0,0,1), boardAngle) + btQuaternion(btVector3(1,0,0), boardAngle2);
-    trans.setRotation(rotation);
-    objects[2]->getMesh()->getMotionState()->setWorldTransform(trans);
-
+	// the board takes the new rotation value in the next step
+	return glm::vec2(angle, angle2);
 }
 
-
 void Engine::mouse(int button, int state, int x_pos, int y_pos)
 {
 	// if right click set flags
@@ -503,30 +1068,31 @@ void Engine::mouseMovement(int x_pos, int y_pos)
 
 	}
 
-	// if left click update board angle
+	// if left click tilt the board, which way depends on the camera angle
 	else if(leftClick) {
+		float tilt = 0.0f, tilt2 = 0.0f;
 		if(defaultCam) {
 			if(x_pos > mouseX)
-				boardAngle -= speed;
+				tilt -= speed;
 			else
-				boardAngle += speed;
+				tilt += speed;
 			if(y_pos > mouseY)
-				boardAngle2 += speed;
+				tilt2 += speed;
 			else
-				boardAngle2 -= speed;
+				tilt2 -= speed;
 			
 			mouseX = x_pos;
 			mouseY = y_pos;
 		}
 		else if(distance*sin(angle) >= 14 && distance * cos(angle) <= 14 ) {
 			if(x_pos > mouseX)
-				boardAngle2 -= speed;
+				tilt2 -= speed;
 			else
-				boardAngle2 += speed;
+				tilt2 += speed;
 			if(y_pos > mouseY)
-				boardAngle -= speed;
+				tilt -= speed;
 			else
-				boardAngle += speed;
+				tilt += speed;
 			
 			mouseX = x_pos;
 			mouseY = y_pos;
@@ -535,13 +1101,13 @@ void Engine::mouseMovement(int x_pos, int y_pos)
 		
 		else if(distance*sin(angle) <= 14 && distance * cos(angle) <= -14 ) {
 			if(x_pos > mouseX)
-				boardAngle += speed;
+				tilt += speed;
 			else
-				boardAngle -= speed;
+				tilt -= speed;
 			if(y_pos > mouseY)
-				boardAngle2 -= speed;
+				tilt2 -= speed;
 			else
-				boardAngle2 += speed;
+				tilt2 += speed;
 		
 			mouseX = x_pos;
 			mouseY = y_pos;
@@ -550,13 +1116,13 @@ void Engine::mouseMovement(int x_pos, int y_pos)
 
 		else if(distance*sin(angle) <= -14 && distance * cos(angle) <= 14 ) {
 			if(x_pos > mouseX)
-				boardAngle2 += speed;
+				tilt2 += speed;
 			else
-				boardAngle2 -= speed;
+				tilt2 -= speed;
 			if(y_pos > mouseY)
-				boardAngle += speed;
+				tilt += speed;
 			else
-				boardAngle -= speed;
+				tilt -= speed;
 			
 			mouseX = x_pos;
 			mouseY = y_pos;
@@ -565,63 +1131,24 @@ void Engine::mouseMovement(int x_pos, int y_pos)
 
 		else if(distance*sin(angle) >= -14 && distance * cos(angle) >= 14 ) {
 			if(x_pos > mouseX)
-				boardAngle -= speed;
+				tilt -= speed;
 			else
-				boardAngle += speed;
+				tilt += speed;
 			if(y_pos > mouseY)
-				boardAngle2 += speed;
+				tilt2 += speed;
 			else
-				boardAngle2 -= speed;
+				tilt2 -= speed;
 			
 			mouseX = x_pos;
 			mouseY = y_pos;
 
 		}
 
-		// limit board rotation
-		if(boardAngle > 0.5) boardAngle = 0.5;
-		if(boardAngle < -0.5) boardAngle = -0.5;
-		if(boardAngle2 > 0.5) boardAngle2 = 0.5;
-		if(boardAngle2 < -0.5) boardAngle2 = -0.5;
-
-		 
-		//std::cout << boardAngle << " " << boardAngle2 << std::endl;
-
-		
-		// update board with new rotation value
-		btTransform trans;
-        objects[0]->getMesh()->getMotionState()->getWorldTransform(trans);
-        auto rotation = trans.getRotation();
-        rotation += btQuaternion(btVector3(0,0,1), boardAngle) + btQuaternion(btVector3(1,0,0), boardAngle2);
-        trans.setRotation(rotation);
-        objects[0]->getMesh()->getMotionState()->setWorldTransform(trans);
-
-        objects[2]->getMesh()->getMotionState()->getWorldTransform(trans);
-        rotation = trans.getRotation();
-        rotation += btQuaternion(btVector3(0,0,1), boardAngle) + btQuaternion(btVector3(1,0,0), boardAngle2);
-        trans.setRotation(rotation);
-        objects[2]->getMesh()->getMotionState()->setWorldTransform(trans);
+		// let the simulation apply it
+		input.push(InputEvent{InputEvent::TILT, 0, tilt, tilt2});
 	}
 }
 
-void Engine::initPhysics()
-{
-	// initialize all variables for creating a physics simulation
-	btBroadphaseInterface *broadphase = new btDbvtBroadphase();
-	btDefaultCollisionConfiguration* collisionConfig = new btDefaultCollisionConfiguration();
-	btCollisionDispatcher *dispatcher = new btCollisionDispatcher(collisionConfig);
-	btSequentialImpulseConstraintSolver* solver = new btSequentialImpulseConstraintSolver();
-
-	// create a physics simulation
-	simulation = new btDiscreteDynamicsWorld(dispatcher, broadphase, solver, collisionConfig);
-
-	// initialize simulation gravity to -50
-	simulation->setGravity(btVector3(0,-50,0));
-
-	// register GImpact algorithm for collisions
-	btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
-}
-
 void Engine::createMenus()
 {
 	// create GLUT menu
@@ -642,28 +1169,17 @@ void Engine::menuActions(int option)
 	switch(option) {
 		// pause simulation
 		case MENU_PAUSE:
-			paused = true;
+			input.push(InputEvent{InputEvent::PAUSE, 0, 0.0f, 0.0f});
 		break;
 
 		// resume simulation
 		case MENU_RESUME:
-			paused = false;
+			input.push(InputEvent{InputEvent::RESUME, 0, 0.0f, 0.0f});
 		break;
 
 		// restart game
 		case MENU_RESTART:
-			// reset game values
-			gameTime = 0.0;
-			gameScore = 0;
-			boardAngle = boardAngle2 = 0.0;
-
-			// reset objects to inital positions
-			reset();
-
-			// reset top ten scores
-			for(int i = 1; i <= 10; i++) {
-				topTenScores[i-1] = std::string("Time: 0.00   Fail Count: 0");
-			}
+			input.push(InputEvent{InputEvent::RESTART, 0, 0.0f, 0.0f});
 		break;
 
 		// exit game
@@ -671,8 +1187,9 @@ void Engine::menuActions(int option)
 			// if linux just leave main loop
 			#ifndef __APPLE__
 				glutLeaveMainLoop();
-			// else kill main thread
+			// else stop the simulation and kill main thread
 			#else
+				stopSimulation();
 				exit(0);
 			#endif
 		break;
@@ -682,6 +1199,16 @@ void Engine::menuActions(int option)
 
 void Engine::renderText(const char *text, glm::vec2 pos, glm::vec3 color)
 {
+	// queue text for the batched HUD, it only changes if the text does
+	if(hud) {
+		hud->setText(textSlot++, text, pos, color);
+		return;
+	}
+
+	// GLUT fonts need a window
+	if(headless)
+		return;
+
 	// init text position
     glRasterPos2f(pos[0],pos[1]);
     // init text color
@@ -18,19 +18,34 @@
 
 #include <iostream>
 #include <chrono>
+#include <cstdlib>
+#include <cmath>
 #include <stdexcept>
 #include <vector>
 #include <sstream>
 #include <algorithm>
+#include <thread>
+#include <atomic>
 
 #include <glm/glm.hpp>
 
-#include <btBulletDynamicsCommon.h>
-#include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
-
 #include "shaderloader.h"
+#include "labyrinth.h"
 #include "simobject.h"
 #include "light.h"
+#include "lightarray.h"
+#include "textrenderer.h"
+#include "uniformring.h"
+#include "renderqueue.h"
+#include "instancebatch.h"
+#include "frustumculler.h"
+#include "assetregistry.h"
+#include "inputqueue.h"
+#include "snapshotbuffer.h"
+#include "profiler.h"
+#include "headlesscontext.h"
+#include "inputlog.h"
+#include "geometryloader.h"
 
 // re-enable warnings
 #ifdef __APPLE__
@@ -45,14 +60,16 @@ public:
 	static int run();
 	static void cleanUp();
 	static float getDT();
-	static glm::mat4 getView();
-	static glm::mat4 getProjection();
-	static void reset();
+	static const glm::mat4& getView();
+	static const glm::mat4& getProjection();
+	static const glm::mat4& getViewProjection();
+	static const glm::mat3& getNormalViewProjection();
+	static UniformRing* getUniformRing();
+	static int getHeight();
 
 	// glut callback functions
 	static void render();
 	static void update();
-	static void score(int x);
 	static void reshape(int new_width, int new_height);
 
 	// input functions
@@ -60,7 +77,7 @@ public:
 	static void keyboardSpecial(int key, int x_pos, int y_pos);
 	static void keyboardUp(unsigned char key, int x_pos, int y_pos);
 	static void keyboardSpecialUp(int key, int x_pos, int y_pos);
-	static void keyboardHandle();
+	static glm::vec2 keyboardHandle();
 	static void mouse(int button, int state, int x_pos, int y_pos);
 	static void mouseMovement(int x_pos, int y_pos);
 	static void createMenus();
@@ -71,15 +88,26 @@ public:
 
 
 private:
-	static void initPhysics();
+	// simulation side, runs on its own thread unless --single-thread is given
+	static void simulate();
+	static void simulateStep();
+	static void publishSnapshot();
+	static void stopSimulation();
+	static void handleInput(const InputEvent& event);
+
+	// offscreen benchmark with a scripted camera and board
+	static int runBenchmark();
+	static void benchmarkScript(int frame);
 
 	// member variables
 	static int width, height;
 	static ShaderLoader vertexShader, fragmentShader;
-	static bool paused, initialized;
+	static std::atomic<bool> paused;
+	static bool initialized;
 	static bool ambient, specular, diffuse;
 	static std::string vertexFile;
 	static std::string fragmentFile;
+	static std::string textVertexFile, textFragmentFile;
 	static std::string scoreText;
 	static int triangleCount;
 	static float zoom;
@@ -89,21 +117,74 @@ private:
 	static std::vector<SimObject*> objects;
 	static glm::mat4 view;
 	static glm::mat4 projection;
+	static glm::mat4 viewProjection;
+	static glm::mat3 normalViewProjection;
+
+	// per frame object matrices, null when they are passed as uniforms
+	static bool uniformRingEnabled;
+	static UniformRing *uniformRing;
 	static bool keyStates[256];
 	static bool keyStatesSpecial[256];
 	static bool rightClick, leftClick, defaultCam;
 	static float mouseX, mouseY, posX, posY, distance, posZ;
-	static float boardAngle, boardAngle2;
-	static float gameTime;
-	static int gameScore;
-	static std::vector<std::string> topTenScores;
+
+	// batched HUD text, renderText fills one slot per call
+	static TextRenderer *hud;
+	static int textSlot;
+
+	// frame timings, shown with 'p'
+	static Profiler *profiler;
+	static bool showProfiler;
+
+	// HUD text that changes every frame is rebuilt this often, the rank labels only once
+	static std::vector<std::string> debugText, profilerText, rankLabels;
+	static std::chrono::time_point<std::chrono::high_resolution_clock> debugRefresh;
+	static const int DEBUG_REFRESH_MS = 250;
+	static unsigned long steps, profiledStep;
+
+	// fixed simulation steps per second, time not yet simulated and
+	// the most steps taken to catch up at once
+	static int simulationRate;
+	static float accumulator;
+	static const int MAX_SUBSTEPS = 8;
+
+	// input written to or read from a file, null when not recording or replaying
+	static InputRecorder *recorder;
+	static InputReplay *replay;
+	static unsigned long replayMismatches;
+
+	// frames of the offscreen benchmark, zero when playing
+	static int benchmarkFrames;
+	static HeadlessContext *headless;
 
 	static std::vector<Light*> lights;
+	static LightArray *lightArray;
+	static int lightCount;
+
+	// smoothed time between frames
+	static float frameTime;
+	static std::chrono::time_point<std::chrono::high_resolution_clock> lastFrame;
+	static RenderQueue renderQueue;
+
+	// extra balls for load testing, drawn in one batch when instancing is on
+	static int ballCount;
+	static bool instancing;
+	static std::vector<SimObject*> balls;
+	static InstanceBatch *ballBatch;
+
+	// visibility of everything drawn
+	static FrustumCuller culler;
+
 
+	// input goes from the callbacks to the simulation and snapshots come back
+	static bool threaded;
+	static std::thread simThread;
+	static std::atomic<bool> running;
+	static InputQueue input;
+	static SnapshotBuffer snapshots;
 
-	// physics
-	static btDiscreteDynamicsWorld* simulation;
-	static btRigidBody *body1, *body2;
+	// game state and physics, drawn through the objects and balls above
+	static Labyrinth *labyrinth;
 };
 
 #endif // ENGINE_H
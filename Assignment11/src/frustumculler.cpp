@@ -0,0 +1,81 @@
+#include "frustumculler.h"
+
+// marks every object the tree reports inside the frustum
+struct VisibleCollector : btDbvt::ICollide
+{
+	int count = 0;
+
+	void Process(const btDbvtNode *leaf)
+	{
+		static_cast<SimObject*>(leaf->data)->setVisible(true);
+		count++;
+	}
+};
+
+// constructor
+FrustumCuller::FrustumCuller()
+	: visibleCount(0)
+{
+}
+
+// destructor
+FrustumCuller::~FrustumCuller()
+{
+	tree.clear();
+}
+
+void FrustumCuller::add(SimObject *object)
+{
+	btVector3 low, high;
+	object->getWorldBounds(low, high);
+
+	objects.push_back(object);
+	leaves.push_back(tree.insert(btDbvtVolume::FromMM(low, high), object));
+}
+
+int FrustumCuller::cull(const glm::mat4& viewProjection)
+{
+	// refit leaves of objects that moved out of their boxes, and assume hidden
+	for(size_t i = 0; i < objects.size(); i++) {
+		btVector3 low, high;
+		objects[i]->getWorldBounds(low, high);
+
+		btDbvtVolume volume = btDbvtVolume::FromMM(low, high);
+		tree.update(leaves[i], volume, MARGIN);
+		objects[i]->setVisible(false);
+	}
+
+	// planes of the frustum from the rows of the view projection matrix,
+	// normals point inside so a point p is in front when dot(n, p) + d >= 0
+	btVector3 normals[6];
+	btScalar offsets[6];
+	for(int i = 0; i < 3; i++) {
+		for(int side = 0; side < 2; side++) {
+			float sign = side ? -1.0f : 1.0f;
+			glm::vec4 plane;
+			for(int j = 0; j < 4; j++)
+				plane[j] = viewProjection[j][3] + sign * viewProjection[j][i];
+
+			normals[i*2 + side] = btVector3(plane.x, plane.y, plane.z);
+			offsets[i*2 + side] = plane.w;
+		}
+	}
+
+	// walk the tree, whole subtrees outside one plane are skipped
+	VisibleCollector collector;
+	if(tree.m_root)
+		btDbvt::collideKDOP(tree.m_root, normals, offsets, 6, collector);
+
+	visibleCount = collector.count;
+	return visibleCount;
+}
+
+int FrustumCuller::getVisibleCount() const
+{
+	return visibleCount;
+}
+
+int FrustumCuller::getCulledCount() const
+{
+	return int(objects.size()) - visibleCount;
+}
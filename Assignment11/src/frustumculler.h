@@ -0,0 +1,56 @@
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <glm/glm.hpp>
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+
+#include <vector>
+
+#include "simobject.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// keeps world bounding boxes of objects in a bounding volume tree and marks
+// the objects inside the view frustum as visible
+class FrustumCuller
+{
+public:
+	// constructor and destructor
+	FrustumCuller();
+	~FrustumCuller();
+	FrustumCuller(const FrustumCuller& other) = delete;
+
+	// start tracking an object, the culler does not own it
+	void add(SimObject *object);
+
+	// refit the tree to the current bounds and mark every object, returns the visible count
+	int cull(const glm::mat4& viewProjection);
+
+	// counts of the last cull
+	int getVisibleCount() const;
+	int getCulledCount() const;
+
+private:
+	// leaves are only refit once an object leaves its box grown by this much
+	static constexpr btScalar MARGIN = 0.25f;
+
+	// member variables, one leaf per object
+	btDbvt tree;
+	std::vector<SimObject*> objects;
+	std::vector<btDbvtNode*> leaves;
+	int visibleCount;
+};
+
+#endif // FRUSTUM_CULLER_H
@@ -0,0 +1,288 @@
+#include "geometryloader.h"
+#include "meshsimplifier.h"
+
+#include <cstring>
+#include <unordered_map>
+
+// hash and compare vertices by their raw attribute bytes
+struct VertexHash
+{
+	size_t operator()(const Vertex& vertex) const
+	{
+		// FNV-1a over every attribute of the vertex
+		const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&vertex);
+		size_t hash = 2166136261u;
+		for(unsigned int i = 0; i < sizeof(Vertex); i++) {
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+};
+
+struct VertexEqual
+{
+	bool operator()(const Vertex& a, const Vertex& b) const
+	{
+		return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+	}
+};
+
+bool GeometryLoader::indexedGeometry = true;
+int GeometryLoader::lodLevels = 4;
+
+GeometryLoader::GeometryLoader(const char *objectFile)
+    : filename(objectFile)
+{
+}
+
+void GeometryLoader::setFileName(std::string fileName)
+{
+	filename = fileName;
+}
+
+bool GeometryLoader::load(MeshData& data)
+{
+	auto cache = std::make_shared<MeshCache>();
+	MeshBuildSettings settings = buildSettings();
+
+	// map geometry straight from the mesh cache if it matches the model and the settings
+	if(!MeshCache::rebuild && cache->open(filename, settings)) {
+		cache->view(data);
+		data.cache = cache;
+
+		std::cout << "Mesh cache: " << MeshCache::cacheName(filename) << std::endl
+				  << "size: " << data.vertexCount << " (" << data.indexCount << " indices)" << std::endl;
+		return true;
+	}
+
+	std::vector<uint32_t> indices;
+	std::vector<MeshLod> lods;
+
+	// otherwise load model through assimp, indexed unless the flat fallback is requested
+	auto geometry = importGeometry(data.triangleCount, data.textureCount, data.lighting);
+	if(indexedGeometry) {
+		geometry = indexGeometry(geometry, indices);
+		lods = buildLods(geometry, indices);
+	}
+
+	else {
+		// output size of model
+		std::cout << "size: " << geometry.size() << std::endl
+				  << "bytes: " << sizeof(Vertex) * geometry.size() << std::endl;
+	}
+
+	data.setGeometry(geometry, indices, lods);
+	data.texturePaths = texturePaths;
+
+	// store geometry for the next launch
+	if(MeshCache::write(filename, data, settings))
+		std::cout << "Mesh cache written: " << MeshCache::cacheName(filename) << std::endl;
+
+	return false;
+}
+
+MeshBuildSettings GeometryLoader::buildSettings()
+{
+	// levels of detail are only built for indexed geometry
+	MeshBuildSettings settings;
+	settings.indexed = indexedGeometry;
+	settings.lodLevels = indexedGeometry ? lodLevels : 1;
+	settings.lodTriangleRatio = LOD_TRIANGLE_RATIO;
+	settings.lodMinReduction = LOD_MIN_REDUCTION;
+	return settings;
+}
+
+std::vector<Vertex> GeometryLoader::indexGeometry(const std::vector<Vertex>& expanded,
+	std::vector<uint32_t>& indices)
+{
+	std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> lookup;
+	std::vector<Vertex> geometry;
+
+	lookup.reserve(expanded.size());
+	indices.clear();
+	indices.reserve(expanded.size());
+
+	// only keep the first copy of each vertex and index the rest
+	for(const Vertex& vertex : expanded) {
+		auto found = lookup.find(vertex);
+
+		if(found == lookup.end()) {
+			found = lookup.emplace(vertex, uint32_t(geometry.size())).first;
+			geometry.push_back(vertex);
+		}
+
+		indices.push_back(found->second);
+	}
+
+	// indices fit in 16 bits for small models
+	size_t indexSize = geometry.size() <= 0xFFFF ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	// output size of model before and after indexing
+	std::cout << "size: " << expanded.size() << " -> " << geometry.size()
+			  << " (" << indices.size() << " indices)" << std::endl
+			  << "bytes: " << sizeof(Vertex) * expanded.size() << " -> "
+			  << sizeof(Vertex) * geometry.size() + indexSize * indices.size() << std::endl;
+
+	// return deduplicated geometry
+	return geometry;
+}
+
+std::vector<MeshLod> GeometryLoader::buildLods(const std::vector<Vertex>& geometry,
+	std::vector<uint32_t>& indices)
+{
+	std::vector<MeshLod> lods(1, MeshLod{0, uint32_t(indices.size())});
+
+	// each level aims for a fraction of the triangles of the level before it
+	for(int level = 1; level < lodLevels; level++) {
+		const MeshLod& previous = lods.back();
+		std::vector<uint32_t> source(indices.begin() + previous.firstIndex,
+			indices.begin() + previous.firstIndex + previous.indexCount);
+
+		auto simplified = MeshSimplifier::simplify(geometry.data(), geometry.size(),
+			source, size_t(source.size() / 3 * LOD_TRIANGLE_RATIO));
+
+		// stop once the mesh can't be reduced any further
+		if(simplified.empty() || simplified.size() > source.size() * LOD_MIN_REDUCTION)
+			break;
+
+		lods.push_back(MeshLod{uint32_t(indices.size()), uint32_t(simplified.size())});
+		indices.insert(indices.end(), simplified.begin(), simplified.end());
+
+		std::cout << "LOD " << level << ": " << simplified.size() / 3 << " triangles" << std::endl;
+	}
+
+	return lods;
+}
+
+std::vector<Vertex> GeometryLoader::importGeometry(int& numTriangles, int& numTextures, Vertex& light)
+{
+	// init variables
+	std::ifstream fileCheck(filename);
+	Vertex tempVert = Vertex();
+	std::vector<Vertex> geometry;
+	std::deque<aiVector3D> texCoord;
+	numTriangles = 0;
+	numTextures = 0;
+	texturePaths.clear();
+
+	// init color to white
+	for(int i = 0; i < 3; i++)
+		tempVert.color[i] = 1.0;
+
+	// if model file doesnt exist, exit
+	if(!fileCheck) {
+		std::cerr << "Error: Unable to open object file: " << filename << std::endl;
+		exit(-1);
+	}
+
+	fileCheck.close();
+
+	// create Assimp importer
+	Assimp::Importer importer;
+
+	// load scene from file
+	auto scene = importer.ReadFile(filename, aiProcessPreset_TargetRealtime_Fast);
+
+	// if scene can't load, exit
+	if(!scene) {
+		std::cerr << "Error: " << importer.GetErrorString() << std::endl;
+		exit(-1);
+	}
+
+	std::cout << "Material Count: " << scene->mNumMaterials << std::endl;
+
+	// if material file exists, load color
+	if(scene->HasMaterials()) {
+		const auto& material = scene->mMaterials[0];
+		aiColor3D color(0.0f,0.0f,0.0);
+		material->Get(AI_MATKEY_COLOR_DIFFUSE, color);
+		light.color[0] = color.r;
+		light.color[1] = color.g;
+		light.color[2] = color.b;
+		float shininess;
+		material->Get(AI_MATKEY_SHININESS, shininess);
+		light.shininess = shininess;
+	}
+
+	// for each mesh load color and geometry
+	for(unsigned int i = 0; i < scene->mNumMeshes; i++) {
+		auto mesh = scene->mMeshes[i];
+
+		// if mesh has material, load color
+		if(scene->mNumMaterials > i+1) {
+			auto material = scene->mMaterials[i+1];
+			float shininess;
+
+			aiColor3D color(1.0f,1.0f,1.0f);
+			material->Get(AI_MATKEY_COLOR_AMBIENT, color);
+			light.color[0] = tempVert.color[0] = color.r;
+			light.color[1] = tempVert.color[1] = color.g;
+			light.color[2] = tempVert.color[2] = color.b;
+			material->Get(AI_MATKEY_COLOR_DIFFUSE, color);
+			light.color[3] = tempVert.color[0] = color.r;
+			light.color[4] = tempVert.color[1] = color.g;
+			light.color[5] = tempVert.color[2] = color.b;
+			material->Get(AI_MATKEY_COLOR_SPECULAR, color);
+			light.color[6] = tempVert.color[6] = color.r;
+			light.color[7] = tempVert.color[7] = color.g;
+			light.color[8] = tempVert.color[8] = color.b;
+		    material->Get(AI_MATKEY_SHININESS, shininess);
+		    light.shininess = tempVert.shininess = shininess;
+
+		    // if texture exists, get path
+			if(material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
+				aiString path;
+
+				// if texture found successfully, load it
+				if(material->GetTexture(aiTextureType_DIFFUSE, 0, &path,
+					NULL, NULL, NULL, NULL, NULL) == AI_SUCCESS) {
+
+					std::cout << "Texture Path: " << path.C_Str() << std::endl;
+
+					// increment texture count
+					numTextures++;
+
+					// remember texture, loaded once geometry is done
+					texturePaths.push_back(path.C_Str());
+				}
+
+			}
+
+		}
+
+		// get number of triangles for mesh
+		numTriangles += mesh->mNumFaces;
+
+		// iterate through mesh faces
+		for(unsigned int j = 0; j < mesh->mNumFaces; j++) {
+			const auto& face = mesh->mFaces[j];
+
+			// for each index in the face, grab vertex position
+			for(unsigned int k = 0; k < face.mNumIndices; k++) {
+				const auto& vertex = mesh->mVertices[face.mIndices[k]];
+				tempVert.position[0] = vertex.x;
+				tempVert.position[1] = vertex.y;
+				tempVert.position[2] = vertex.z;
+
+				// grab texture coordinates if they exist
+				const auto& textureVertex = mesh->HasTextureCoords(0) ? mesh->mTextureCoords[0][face.mIndices[k]]
+						: aiVector3D(0,0,0);
+				tempVert.textCoord[0] = textureVertex[0];
+				tempVert.textCoord[1] = textureVertex[1];
+
+				// get normal values
+				const auto& normals = mesh->mNormals[face.mIndices[k]];
+				tempVert.normal[0] = normals.x;
+				tempVert.normal[1] = normals.y;
+				tempVert.normal[2] = normals.z;
+
+				// add vertex to geometry vector
+				geometry.push_back(tempVert);
+			}
+		}
+	}
+
+	// return object geometry
+	return geometry;
+}
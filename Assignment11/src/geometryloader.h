@@ -0,0 +1,86 @@
+#ifndef GEOMETRY_LOADER_H
+#define GEOMETRY_LOADER_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+
+// if using assimp version 2, load different headers
+#ifdef ASSIMP_2
+#include <assimp/assimp.hpp>
+#include <assimp/aiScene.h>
+#include <assimp/aiPostProcess.h>
+
+#else // assimp version 3
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#endif
+
+#include "vertex.h"
+#include "meshdata.h"
+#include "meshcache.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// imports the geometry of a model file without any OpenGL, so the
+// physics-only build loads models through it as well
+class GeometryLoader
+{
+public:
+	// constructor and destructor
+	GeometryLoader(const char *objectFile = "model.obj");
+	~GeometryLoader() {}
+
+	// update filename to new name
+	void setFileName(std::string fileName);
+
+	// used to load geometry through the binary mesh cache, true if cache was used,
+	// may run on any thread
+	bool load(MeshData& data);
+
+	// toggles the indexed geometry path, flat triangle lists are the fallback
+	static bool indexedGeometry;
+
+	// number of levels of detail built for indexed models, including the full mesh
+	static int lodLevels;
+
+	// fraction of triangles each level of detail aims to keep of the level before it,
+	// and the largest fraction that still counts as simpler
+	static constexpr float LOD_TRIANGLE_RATIO = 0.5f;
+	static constexpr float LOD_MIN_REDUCTION = 0.75f;
+
+protected:
+	// settings that decide the cached geometry, a cache built with others is rebuilt
+	static MeshBuildSettings buildSettings();
+
+	// used to expand every face of the object file into a triangle list
+	std::vector<Vertex> importGeometry(int& numTriangles, int& numTextures, Vertex& light);
+
+	// used to deduplicate a triangle list into vertices and indices
+	static std::vector<Vertex> indexGeometry(const std::vector<Vertex>& expanded,
+		std::vector<uint32_t>& indices);
+
+	// used to append simplified levels of detail to the indices
+	static std::vector<MeshLod> buildLods(const std::vector<Vertex>& geometry,
+		std::vector<uint32_t>& indices);
+
+	// member variables
+	std::string filename;
+	std::vector<std::string> texturePaths;
+};
+
+#endif // GEOMETRY_LOADER_H
@@ -0,0 +1,196 @@
+#include "glstate.h"
+
+#include <cstring>
+
+const GLuint GLState::UNKNOWN;
+
+// a new context starts with everything unbound
+GLuint GLState::program = 0, GLState::arrayBuffer = 0, GLState::vertexArray = 0;
+GLenum GLState::textureUnit = GL_TEXTURE0;
+GLuint GLState::textures[GLState::MAX_TEXTURE_UNITS] = {};
+std::unordered_map<GLuint, GLuint> GLState::elementBuffers;
+std::unordered_map<GLuint, std::unordered_map<GLint, GLState::Uniform>> GLState::uniforms;
+unsigned long GLState::issuedCalls = 0, GLState::skippedCalls = 0;
+
+void GLState::useProgram(GLuint newProgram)
+{
+	if(count(program != newProgram)) {
+		glUseProgram(newProgram);
+		program = newProgram;
+	}
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+	GLuint *bound = nullptr;
+
+	// only vertex and index buffers are tracked
+	if(target == GL_ARRAY_BUFFER)
+		bound = &arrayBuffer;
+	else if(target == GL_ELEMENT_ARRAY_BUFFER && vertexArray != UNKNOWN)
+		bound = &elementBuffers.emplace(vertexArray, UNKNOWN).first->second;
+
+	if(count(!bound || *bound != buffer)) {
+		glBindBuffer(target, buffer);
+		if(bound)
+			*bound = buffer;
+	}
+}
+
+void GLState::bindVertexArray(GLuint newVertexArray)
+{
+	if(count(vertexArray != newVertexArray)) {
+		glBindVertexArray(newVertexArray);
+		vertexArray = newVertexArray;
+	}
+}
+
+void GLState::activeTexture(GLenum unit)
+{
+	if(count(textureUnit != unit)) {
+		glActiveTexture(unit);
+		textureUnit = unit;
+	}
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture)
+{
+	// only 2D textures are tracked
+	unsigned int unit = textureUnit - GL_TEXTURE0;
+	GLuint *bound = target == GL_TEXTURE_2D && textureUnit != UNKNOWN && unit < MAX_TEXTURE_UNITS
+		? &textures[unit] : nullptr;
+
+	if(count(!bound || *bound != texture)) {
+		glBindTexture(target, texture);
+		if(bound)
+			*bound = texture;
+	}
+}
+
+void GLState::uniform1i(GLint location, GLint value)
+{
+	GLfloat bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	if(!cachedUniform(location, GL_INT, &bits, 1))
+		glUniform1i(location, value);
+}
+
+void GLState::uniform1f(GLint location, GLfloat value)
+{
+	if(!cachedUniform(location, GL_FLOAT, &value, 1))
+		glUniform1f(location, value);
+}
+
+void GLState::uniform2f(GLint location, GLfloat x, GLfloat y)
+{
+	GLfloat values[2] = {x, y};
+
+	if(!cachedUniform(location, GL_FLOAT_VEC2, values, 2))
+		glUniform2f(location, x, y);
+}
+
+void GLState::uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
+{
+	GLfloat values[4] = {x, y, z, w};
+
+	if(!cachedUniform(location, GL_FLOAT_VEC4, values, 4))
+		glUniform4f(location, x, y, z, w);
+}
+
+void GLState::uniform4fv(GLint location, GLsizei count, const GLfloat *values)
+{
+	if(!cachedUniform(location, GL_FLOAT_VEC4, values, count * 4))
+		glUniform4fv(location, count, values);
+}
+
+void GLState::uniformMatrix4fv(GLint location, const GLfloat *value)
+{
+	if(!cachedUniform(location, GL_FLOAT_MAT4, value, 16))
+		glUniformMatrix4fv(location, 1, GL_FALSE, value);
+}
+
+void GLState::deleteBuffer(GLuint buffer)
+{
+	glDeleteBuffers(1, &buffer);
+
+	// deleting a bound buffer unbinds it
+	if(arrayBuffer == buffer)
+		arrayBuffer = 0;
+	for(auto& bound : elementBuffers)
+		if(bound.second == buffer)
+			bound.second = bound.first == vertexArray ? 0 : UNKNOWN;
+}
+
+void GLState::deleteTexture(GLuint texture)
+{
+	glDeleteTextures(1, &texture);
+
+	for(GLuint& bound : textures)
+		if(bound == texture)
+			bound = 0;
+}
+
+void GLState::deleteVertexArray(GLuint deleted)
+{
+	glDeleteVertexArrays(1, &deleted);
+
+	if(vertexArray == deleted)
+		vertexArray = 0;
+	elementBuffers.erase(deleted);
+}
+
+void GLState::invalidate()
+{
+	program = arrayBuffer = vertexArray = UNKNOWN;
+	textureUnit = UNKNOWN;
+	for(GLuint& bound : textures)
+		bound = UNKNOWN;
+	elementBuffers.clear();
+	uniforms.clear();
+}
+
+unsigned long GLState::getIssuedCalls()
+{
+	return issuedCalls;
+}
+
+unsigned long GLState::getSkippedCalls()
+{
+	return skippedCalls;
+}
+
+void GLState::resetCounters()
+{
+	issuedCalls = skippedCalls = 0;
+}
+
+bool GLState::cachedUniform(GLint location, GLenum type, const GLfloat *values, int valueCount)
+{
+	// GL ignores location -1, and without a known program there is nothing to compare with
+	if(location == -1)
+		return true;
+	if(program == UNKNOWN)
+		return !count(true);
+
+	Uniform& cached = uniforms[program][location];
+	bool changed = cached.type != type || cached.values.size() != size_t(valueCount)
+		|| std::memcmp(cached.values.data(), values, sizeof(GLfloat) * valueCount) != 0;
+
+	if(changed) {
+		cached.type = type;
+		cached.values.assign(values, values + valueCount);
+	}
+
+	return !count(changed);
+}
+
+bool GLState::count(bool changed)
+{
+	if(changed)
+		issuedCalls++;
+	else
+		skippedCalls++;
+
+	return changed;
+}
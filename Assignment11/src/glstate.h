@@ -0,0 +1,83 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+
+#include <unordered_map>
+#include <vector>
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// cache in front of GL binds and uniform uploads, calls that would not
+// change anything are skipped and counted
+class GLState
+{
+public:
+	// bindings
+	static void useProgram(GLuint program);
+	static void bindBuffer(GLenum target, GLuint buffer);
+	static void bindVertexArray(GLuint vertexArray);
+	static void activeTexture(GLenum unit);
+	static void bindTexture(GLenum target, GLuint texture);
+
+	// uniforms of the program in use, remembered per program
+	static void uniform1i(GLint location, GLint value);
+	static void uniform1f(GLint location, GLfloat value);
+	static void uniform2f(GLint location, GLfloat x, GLfloat y);
+	static void uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+	static void uniform4fv(GLint location, GLsizei count, const GLfloat *values);
+	static void uniformMatrix4fv(GLint location, const GLfloat *value);
+
+	// delete objects and forget any binding of their names
+	static void deleteBuffer(GLuint buffer);
+	static void deleteTexture(GLuint texture);
+	static void deleteVertexArray(GLuint vertexArray);
+
+	// forget everything, for code that changes state without the cache
+	static void invalidate();
+
+	// calls passed on to GL and calls skipped since the last reset
+	static unsigned long getIssuedCalls();
+	static unsigned long getSkippedCalls();
+	static void resetCounters();
+
+private:
+	// value of one uniform location, arrays keep all their elements
+	struct Uniform
+	{
+		GLenum type;
+		std::vector<GLfloat> values;
+	};
+
+	// true if the value matches the cache, otherwise stores it
+	static bool cachedUniform(GLint location, GLenum type, const GLfloat *values, int count);
+
+	// count a call as issued if changed is true and as skipped otherwise
+	static bool count(bool changed);
+
+	// name used for bindings the cache knows nothing about
+	static const GLuint UNKNOWN = ~0u;
+	static const int MAX_TEXTURE_UNITS = 32;
+
+	static GLuint program, arrayBuffer, vertexArray;
+	static GLenum textureUnit;
+	static GLuint textures[MAX_TEXTURE_UNITS];
+
+	// index buffers are part of the vertex array, so one per vertex array
+	static std::unordered_map<GLuint, GLuint> elementBuffers;
+	static std::unordered_map<GLuint, std::unordered_map<GLint, Uniform>> uniforms;
+
+	static unsigned long issuedCalls, skippedCalls;
+};
+
+#endif // GL_STATE_H
@@ -0,0 +1,118 @@
+#include "headlesscontext.h"
+
+#include <iostream>
+#include <stdexcept>
+
+// EGL without X11 types, the benchmark never opens a display
+#ifndef __APPLE__
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// constructor
+HeadlessContext::HeadlessContext()
+	: display(nullptr), surface(nullptr), context(nullptr), framebuffer(0), colorBuffer(0), depthBuffer(0)
+{
+#ifdef __APPLE__
+	throw std::runtime_error("Headless rendering needs EGL in HeadlessContext::HeadlessContext()");
+#else
+	// prefer Mesa's surfaceless platform, it needs no display server at all
+	EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+	const char *extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if(extensions && std::string(extensions).find("EGL_MESA_platform_surfaceless") != std::string::npos && getPlatformDisplay)
+		eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	if(eglDisplay == EGL_NO_DISPLAY)
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major, minor;
+	if(eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor))
+		throw std::runtime_error("Unable to initialize EGL in HeadlessContext::HeadlessContext()");
+	display = eglDisplay;
+
+	// desktop OpenGL, the shaders and HUD use the compatibility profile
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+		EGL_DEPTH_SIZE, 24,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+	if(!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0) {
+		eglTerminate(eglDisplay);
+		throw std::runtime_error("No OpenGL config in HeadlessContext::HeadlessContext()");
+	}
+
+	EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, nullptr);
+	if(eglContext == EGL_NO_CONTEXT) {
+		eglTerminate(eglDisplay);
+		throw std::runtime_error("Unable to create context in HeadlessContext::HeadlessContext()");
+	}
+	context = eglContext;
+
+	// a tiny pbuffer to make current, or none at all where the driver allows it,
+	// everything is drawn into the framebuffer object either way
+	const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+	EGLSurface eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttributes);
+	if(eglSurface != EGL_NO_SURFACE)
+		surface = eglSurface;
+
+	if(!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+		if(eglSurface != EGL_NO_SURFACE)
+			eglDestroySurface(eglDisplay, eglSurface);
+		eglDestroyContext(eglDisplay, eglContext);
+		eglTerminate(eglDisplay);
+		throw std::runtime_error("Unable to make context current in HeadlessContext::HeadlessContext()");
+	}
+#endif
+}
+
+// destructor
+HeadlessContext::~HeadlessContext()
+{
+#ifndef __APPLE__
+	if(framebuffer) {
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &colorBuffer);
+		glDeleteRenderbuffers(1, &depthBuffer);
+	}
+
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if(surface)
+		eglDestroySurface(display, surface);
+	eglDestroyContext(display, context);
+	eglTerminate(display);
+#endif
+}
+
+void HeadlessContext::createFramebuffer(int width, int height)
+{
+	// color and depth like the window would have
+	glGenRenderbuffers(1, &colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+	if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		throw std::runtime_error("Incomplete framebuffer in HeadlessContext::createFramebuffer()");
+
+	// stays bound for the whole run
+	glViewport(0, 0, width, height);
+}
+
+std::string HeadlessContext::getRenderer() const
+{
+	return std::string((const char*)glGetString(GL_RENDERER)) + ", OpenGL " + (const char*)glGetString(GL_VERSION);
+}
@@ -0,0 +1,42 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+
+#include <string>
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// OpenGL context without a window for benchmarks on machines without a display,
+// made with EGL and drawn into a framebuffer object
+class HeadlessContext
+{
+public:
+	// constructor and destructor, the constructor makes the context current
+	HeadlessContext();
+	~HeadlessContext();
+	HeadlessContext(const HeadlessContext& other) = delete;
+
+	// render into an offscreen framebuffer of this size, needs GLEW initialized
+	void createFramebuffer(int width, int height);
+
+	// renderer and version string of the context
+	std::string getRenderer() const;
+
+private:
+	// member variables, EGL handles are kept opaque so its headers stay out of the engine
+	void *display, *surface, *context;
+	GLuint framebuffer, colorBuffer, depthBuffer;
+};
+
+#endif // HEADLESS_CONTEXT_H
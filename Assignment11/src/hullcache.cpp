@@ -0,0 +1,117 @@
+#include "hullcache.h"
+#include "meshcache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+bool HullCache::read(const std::string& modelFile, ConvexHulls& hulls)
+{
+	HullCacheHeader header;
+	uint64_t time, size, hash;
+
+	// get key of the current model file
+	if(!MeshCache::sourceKey(modelFile, time, size, hash))
+		return false;
+
+	std::ifstream fin(cacheName(modelFile), std::ios::binary);
+	if(!fin)
+		return false;
+
+	// reject other versions and changed models
+	fin.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if(!fin || std::memcmp(header.magic, "LHUL", 4) != 0 || header.version != VERSION
+		|| header.sourceTime != time || header.sourceSize != size || header.sourceHash != hash)
+		return false;
+
+	// a truncated or padded file isn't one that write produced, checked before allocating
+	uint64_t dataSize = uint64_t(header.hullCount) * sizeof(uint32_t) + uint64_t(header.vertexCount) * 3 * sizeof(float);
+	std::streamoff dataStart = fin.tellg();
+	fin.seekg(0, std::ios::end);
+	if(!fin || uint64_t(fin.tellg() - dataStart) != dataSize)
+		return false;
+	fin.seekg(dataStart);
+
+	std::vector<uint32_t> counts(header.hullCount);
+	std::vector<float> positions(size_t(header.vertexCount) * 3);
+	fin.read(reinterpret_cast<char*>(counts.data()), counts.size() * sizeof(uint32_t));
+	fin.read(reinterpret_cast<char*>(positions.data()), positions.size() * sizeof(float));
+	if(!fin)
+		return false;
+
+	// split the vertex list back into hulls
+	ConvexHulls cached(header.hullCount);
+	size_t vertex = 0;
+	for(uint32_t i = 0; i < header.hullCount; i++) {
+		if(vertex + counts[i] > header.vertexCount)
+			return false;
+
+		for(uint32_t j = 0; j < counts[i]; j++, vertex++)
+			cached[i].push_back(btVector3(positions[vertex*3], positions[vertex*3+1], positions[vertex*3+2]));
+	}
+
+	if(vertex != header.vertexCount)
+		return false;
+
+	// only hand out the hulls once all of them were read
+	hulls.swap(cached);
+	return true;
+}
+
+bool HullCache::write(const std::string& modelFile, const ConvexHulls& hulls,
+	const ConvexDecomposition::Settings& settings)
+{
+	HullCacheHeader header;
+	std::vector<uint32_t> counts;
+	std::vector<float> positions;
+
+	// zero padding so identical hulls produce identical files
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, "LHUL", 4);
+	header.version = VERSION;
+
+	if(!MeshCache::sourceKey(modelFile, header.sourceTime, header.sourceSize, header.sourceHash))
+		return false;
+
+	for(const std::vector<btVector3>& hull : hulls) {
+		counts.push_back(hull.size());
+		for(const btVector3& vertex : hull) {
+			positions.push_back(vertex.x());
+			positions.push_back(vertex.y());
+			positions.push_back(vertex.z());
+		}
+	}
+
+	header.concavity = settings.concavity;
+	header.resolution = settings.resolution;
+	header.maxHulls = settings.maxHulls;
+	header.hullCount = counts.size();
+	header.vertexCount = positions.size() / 3;
+
+	// write to a temporary file and rename so readers never see a partial cache
+	std::string tempName = cacheName(modelFile) + ".tmp";
+	std::ofstream fout(tempName, std::ios::binary | std::ios::trunc);
+	if(!fout) {
+		std::cerr << "Unable to write hull cache: " << cacheName(modelFile) << std::endl;
+		return false;
+	}
+
+	fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	fout.write(reinterpret_cast<const char*>(counts.data()), counts.size() * sizeof(uint32_t));
+	fout.write(reinterpret_cast<const char*>(positions.data()), positions.size() * sizeof(float));
+	fout.close();
+
+	if(!fout || std::rename(tempName.c_str(), cacheName(modelFile).c_str()) != 0) {
+		std::cerr << "Unable to write hull cache: " << cacheName(modelFile) << std::endl;
+		std::remove(tempName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::string HullCache::cacheName(const std::string& modelFile)
+{
+	return modelFile + ".hulls";
+}
@@ -0,0 +1,44 @@
+#ifndef HULL_CACHE_H
+#define HULL_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include "convexdecomposition.h"
+
+// header at the start of every hull cache file
+struct HullCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+
+	// key of the model file the hulls were built from
+	uint64_t sourceTime, sourceSize, sourceHash;
+
+	// settings the hulls were built with
+	float concavity;
+	int32_t resolution, maxHulls;
+
+	// vertex count of every hull follows the header, then every vertex
+	uint32_t hullCount, vertexCount;
+};
+
+// convex decomposition of a model, stored next to the model file
+class HullCache
+{
+public:
+	// read cache file of a model if it still matches the model,
+	// hulls built with any settings are accepted
+	static bool read(const std::string& modelFile, ConvexHulls& hulls);
+
+	// write cache file for the hulls of a model
+	static bool write(const std::string& modelFile, const ConvexHulls& hulls,
+		const ConvexDecomposition::Settings& settings);
+
+	// name of the cache file belonging to a model
+	static std::string cacheName(const std::string& modelFile);
+
+	static const uint32_t VERSION = 1;
+};
+
+#endif // HULL_CACHE_H
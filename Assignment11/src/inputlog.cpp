@@ -0,0 +1,131 @@
+#include "inputlog.h"
+
+#include <cstring>
+#include <stdexcept>
+
+// file starts with these, followed by the settings and then tagged records
+static const char MAGIC[4] = {'L', 'A', 'B', 'R'};
+static const uint32_t VERSION = 2;
+static const uint8_t EVENT_TAG = 0, STEP_TAG = 1;
+
+// read a value written by InputRecorder::write
+template <typename T>
+static bool read(std::ifstream& file, T& value)
+{
+	return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// constructor
+InputRecorder::InputRecorder(const std::string& filename, const RecordingSettings& settings)
+	: file(filename, std::ios::binary)
+{
+	if(!file)
+		throw std::runtime_error("Unable to write " + filename + " in InputRecorder::InputRecorder()");
+
+	file.write(MAGIC, sizeof(MAGIC));
+	write(VERSION);
+	write(settings.simulationRate);
+	write(settings.ballCount);
+	write(settings.collisionHulls);
+	write(settings.serializedShapes);
+}
+
+// destructor
+InputRecorder::~InputRecorder()
+{
+	file.flush();
+}
+
+void InputRecorder::addEvent(uint32_t step, const InputEvent& event)
+{
+	write(EVENT_TAG);
+	write(step);
+	write(uint8_t(event.type));
+	write(uint8_t(event.key));
+	write(event.angle);
+	write(event.angle2);
+}
+
+void InputRecorder::addStep(const StepRecord& record)
+{
+	write(STEP_TAG);
+	write(record.boardAngle);
+	write(record.boardAngle2);
+	write(record.checksum);
+}
+
+template <typename T>
+void InputRecorder::write(const T& value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// constructor
+InputReplay::InputReplay(const std::string& filename)
+	: nextEventIndex(0)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if(!file)
+		throw std::runtime_error("Unable to read " + filename + " in InputReplay::InputReplay()");
+
+	char magic[sizeof(MAGIC)];
+	uint32_t version = 0;
+	if(!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+			|| !read(file, version) || version != VERSION
+			|| !read(file, settings.simulationRate) || !read(file, settings.ballCount)
+			|| !read(file, settings.collisionHulls) || !read(file, settings.serializedShapes))
+		throw std::runtime_error(filename + " is not a recording in InputReplay::InputReplay()");
+
+	// records until the end, a cut off last record is dropped
+	uint8_t tag;
+	while(read(file, tag)) {
+		if(tag == EVENT_TAG) {
+			TimedEvent timed;
+			uint8_t type, key;
+			if(!read(file, timed.step) || !read(file, type) || !read(file, key)
+					|| !read(file, timed.event.angle) || !read(file, timed.event.angle2))
+				break;
+
+			timed.event.type = InputEvent::Type(type);
+			timed.event.key = key;
+			events.push_back(timed);
+		}
+		else if(tag == STEP_TAG) {
+			StepRecord record;
+			if(!read(file, record.boardAngle) || !read(file, record.boardAngle2) || !read(file, record.checksum))
+				break;
+
+			steps.push_back(record);
+		}
+		else {
+			throw std::runtime_error(filename + " is damaged in InputReplay::InputReplay()");
+		}
+	}
+
+	if(steps.empty())
+		throw std::runtime_error(filename + " has no steps in InputReplay::InputReplay()");
+}
+
+const RecordingSettings& InputReplay::getSettings() const
+{
+	return settings;
+}
+
+bool InputReplay::nextEvent(uint32_t step, InputEvent& event)
+{
+	if(nextEventIndex >= events.size() || events[nextEventIndex].step > step)
+		return false;
+
+	event = events[nextEventIndex++].event;
+	return true;
+}
+
+const StepRecord* InputReplay::getStep(uint32_t step) const
+{
+	return step < steps.size() ? &steps[step] : nullptr;
+}
+
+uint32_t InputReplay::getStepCount() const
+{
+	return steps.size();
+}
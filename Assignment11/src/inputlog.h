@@ -0,0 +1,84 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "inputqueue.h"
+
+// settings that change the simulation, a recording replays only with the same ones
+struct RecordingSettings
+{
+	uint32_t simulationRate;
+	uint32_t ballCount;
+	uint8_t collisionHulls;
+	uint8_t serializedShapes;
+};
+
+// board angles one fixed step was taken with and a checksum of the simulation state after it
+struct StepRecord
+{
+	float boardAngle, boardAngle2;
+	uint32_t checksum;
+};
+
+// writes the input of a game to a binary file, each event tagged with the step it went in before
+class InputRecorder
+{
+public:
+	// constructor and destructor, the file is written as the game goes
+	InputRecorder(const std::string& filename, const RecordingSettings& settings);
+	~InputRecorder();
+	InputRecorder(const InputRecorder& other) = delete;
+
+	// add an event applied before a step
+	void addEvent(uint32_t step, const InputEvent& event);
+
+	// add the outcome of the next step
+	void addStep(const StepRecord& record);
+
+private:
+	// write a value without padding
+	template <typename T>
+	void write(const T& value);
+
+	// member variables
+	std::ofstream file;
+};
+
+// reads a whole recording to feed it back step by step
+class InputReplay
+{
+public:
+	// constructor, throws if the file isn't a recording
+	InputReplay(const std::string& filename);
+	InputReplay(const InputReplay& other) = delete;
+
+	// settings the recording was made with
+	const RecordingSettings& getSettings() const;
+
+	// take the next event recorded before a step, false once there are no more for it
+	bool nextEvent(uint32_t step, InputEvent& event);
+
+	// recorded outcome of a step, null past the end of the recording
+	const StepRecord* getStep(uint32_t step) const;
+	uint32_t getStepCount() const;
+
+private:
+	// an event with the step it goes in before
+	struct TimedEvent
+	{
+		uint32_t step;
+		InputEvent event;
+	};
+
+	// member variables
+	RecordingSettings settings;
+	std::vector<TimedEvent> events;
+	std::vector<StepRecord> steps;
+	size_t nextEventIndex;
+};
+
+#endif // INPUT_LOG_H
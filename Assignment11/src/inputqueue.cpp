@@ -0,0 +1,31 @@
+#include "inputqueue.h"
+
+// constructor
+InputQueue::InputQueue()
+	: head(0), tail(0)
+{
+}
+
+bool InputQueue::push(const InputEvent& event)
+{
+	size_t current = tail.load(std::memory_order_relaxed);
+	if(current - head.load(std::memory_order_acquire) == CAPACITY)
+		return false;
+
+	// publish the event only after it is written
+	events[current & (CAPACITY - 1)] = event;
+	tail.store(current + 1, std::memory_order_release);
+	return true;
+}
+
+bool InputQueue::pop(InputEvent& event)
+{
+	size_t current = head.load(std::memory_order_relaxed);
+	if(current == tail.load(std::memory_order_acquire))
+		return false;
+
+	// free the slot only after it is read
+	event = events[current & (CAPACITY - 1)];
+	head.store(current + 1, std::memory_order_release);
+	return true;
+}
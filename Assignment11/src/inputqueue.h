@@ -0,0 +1,55 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// one input for the simulation, produced by the GLUT callbacks
+struct InputEvent
+{
+	enum Type {
+		KEY_DOWN,
+		KEY_UP,
+		SPECIAL_DOWN,
+		SPECIAL_UP,
+		TILT,
+		FINISH,
+		PAUSE,
+		RESUME,
+		RESTART
+	};
+
+	Type type;
+
+	// key code for key events
+	int key;
+
+	// board angle change for tilt events
+	float angle, angle2;
+};
+
+// fixed size ring of input events without locks, safe for one thread
+// pushing and one thread popping at the same time
+class InputQueue
+{
+public:
+	// constructor
+	InputQueue();
+	InputQueue(const InputQueue& other) = delete;
+
+	// add an event, false if the queue is full and the event was dropped
+	bool push(const InputEvent& event);
+
+	// take the oldest event, false if there is none
+	bool pop(InputEvent& event);
+
+private:
+	// power of two so indices wrap with a mask
+	static const size_t CAPACITY = 1024;
+
+	// member variables, the producer only writes tail and the consumer only writes head
+	InputEvent events[CAPACITY];
+	std::atomic<size_t> head, tail;
+};
+
+#endif // INPUT_QUEUE_H
@@ -0,0 +1,149 @@
+#include "instancebatch.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cstring>
+
+// constructor
+InstanceBatch::InstanceBatch(GLuint program, const std::vector<SimObject*>& instances)
+	: program(program), instances(instances), transforms(instances.size() * 16), vao(0), instanceBuffer(0)
+{
+	// if nothing to draw or the context can't draw instances, throw an error
+	if(instances.empty() || !supported())
+		throw std::runtime_error("Instancing unavailable in InstanceBatch::InstanceBatch()");
+
+	// get instance locations from OpenGL program, a mat4 attribute takes four in a row
+	loc_instanced = glGetUniformLocation(program, "instanced");
+	loc_model = glGetAttribLocation(program, "v_model");
+
+	if(loc_instanced == -1 || loc_model == -1) {
+		std::cerr << loc_instanced << "\n"
+				  << loc_model << std::endl;
+		throw std::runtime_error("Unable to get locations in InstanceBatch::InstanceBatch()");
+	}
+
+	// buffer of one model matrix per instance, refilled every frame
+	glGenBuffers(1, &instanceBuffer);
+
+	// record the mesh attributes of the first instance plus the instance matrices
+	glGenVertexArrays(1, &vao);
+	GLState::bindVertexArray(vao);
+	instances[0]->setupAttributes();
+
+	GLState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	for(int column = 0; column < 4; column++) {
+		glEnableVertexAttribArray(loc_model + column);
+		glVertexAttribPointer(loc_model + column, 4, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 16,
+			(void*)(sizeof(GLfloat) * 4 * column));
+
+		// advance once per instance instead of once per vertex
+		if(GLEW_VERSION_3_3)
+			glVertexAttribDivisor(loc_model + column, 1);
+		else
+			glVertexAttribDivisorARB(loc_model + column, 1);
+	}
+
+	GLState::bindVertexArray(0);
+}
+
+// destructor
+InstanceBatch::~InstanceBatch()
+{
+	GLState::deleteVertexArray(vao);
+	GLState::deleteBuffer(instanceBuffer);
+}
+
+void InstanceBatch::submit(RenderQueue& queue)
+{
+	// nothing to draw if every instance is culled
+	if(std::none_of(instances.begin(), instances.end(), [](const SimObject *instance) { return instance->isVisible(); }))
+		return;
+
+	// instances carry their own model matrix, so the packet only holds view and projection
+	// and the normal matrix of the camera, the shader applies the model rotation to both
+	const std::shared_ptr<MeshAsset>& asset = instances[0]->asset;
+	uniforms = ObjectUniforms::fromModel(glm::mat4(1.0f));
+	DrawPacket packet = {this, program, 0, -1};
+
+	if(UniformRing *ring = Engine::getUniformRing()) {
+		packet.uniformOffset = ring->push(&uniforms, sizeof(uniforms));
+	}
+
+	// sort next to single objects of the same model
+	GLuint texture = asset->getTextureCount() > 0 ? asset->getTexture(0) : 0;
+	queue.submit(packet, texture, asset->getVBO(), 0.0f);
+}
+
+void InstanceBatch::draw(const DrawPacket& packet)
+{
+	const std::shared_ptr<MeshAsset>& asset = instances[0]->asset;
+	const SimObject& first = *instances[0];
+
+	// copy model matrices of visible instances straight into the matrix buffer
+	GLsizei count = 0;
+	for(SimObject *instance : instances) {
+		if(!instance->isVisible())
+			continue;
+
+		std::memcpy(&transforms[count++ * 16], glm::value_ptr(instance->getModel()), sizeof(GLfloat) * 16);
+	}
+
+	// reallocate the buffer so the driver doesn't wait for last frame's draw
+	GLState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 16 * count, transforms.data(), GL_STREAM_DRAW);
+
+	// pass view projection and camera normal matrices, the shader applies the instance matrices
+	if(packet.uniformOffset >= 0) {
+		Engine::getUniformRing()->bind(ObjectUniforms::BINDING, packet.uniformOffset, sizeof(ObjectUniforms));
+	}
+	else {
+		GLState::uniformMatrix4fv(first.loc_mvp, glm::value_ptr(uniforms.mvp));
+		GLState::uniformMatrix4fv(first.loc_normalMatrix, glm::value_ptr(uniforms.normalMatrix));
+	}
+	GLState::uniform1i(loc_instanced, 1);
+	GLState::bindVertexArray(vao);
+
+	// send texture locations for all textures
+	int textureCount = asset->getTextureCount();
+	GLState::uniform1i(first.loc_hasTexture, textureCount);
+	for(int i = 0; i < textureCount; i++) {
+		GLState::uniform1i(first.loc_texture, i);
+		GLState::activeTexture(GL_TEXTURE0 + i);
+		GLState::bindTexture(GL_TEXTURE_2D, asset->getTexture(i));
+	}
+
+	// draw all visible instances at full detail
+	if(asset->getIBO()) {
+		const MeshLod& lod = asset->getLod(packet.lod);
+		void *offset = (void*)(size_t(lod.firstIndex) * asset->getIndexSize());
+
+		if(GLEW_VERSION_3_1)
+			glDrawElementsInstanced(GL_TRIANGLES, lod.indexCount, asset->getIndexType(), offset, count);
+		else
+			glDrawElementsInstancedARB(GL_TRIANGLES, lod.indexCount, asset->getIndexType(), offset, count);
+	}
+
+	else {
+		if(GLEW_VERSION_3_1)
+			glDrawArraysInstanced(GL_TRIANGLES, 0, asset->getTriangleCount()*3, count);
+		else
+			glDrawArraysInstancedARB(GL_TRIANGLES, 0, asset->getTriangleCount()*3, count);
+	}
+
+	// back to single objects for the rest of the queue
+	GLState::bindVertexArray(0);
+	GLState::uniform1i(loc_instanced, 0);
+}
+
+size_t InstanceBatch::size() const
+{
+	return instances.size();
+}
+
+bool InstanceBatch::supported()
+{
+	// the batch records its attributes in a vertex array object
+	bool vertexArrays = GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object;
+	bool instancing = GLEW_VERSION_3_3 || (GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced);
+	return vertexArrays && instancing;
+}
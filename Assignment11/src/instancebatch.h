@@ -0,0 +1,59 @@
+#ifndef INSTANCE_BATCH_H
+#define INSTANCE_BATCH_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+
+#include <vector>
+
+#include "simobject.h"
+#include "renderqueue.h"
+#include "glstate.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// draws many objects of the same model with one instanced draw call,
+// the objects keep their own physics and only stop drawing themselves
+class InstanceBatch : public Drawable
+{
+public:
+	// constructor and destructor, all instances must share one model
+	InstanceBatch(GLuint program, const std::vector<SimObject*>& instances);
+	~InstanceBatch();
+	InstanceBatch(const InstanceBatch& other) = delete;
+
+	// queue one draw for all instances
+	void submit(RenderQueue& queue);
+
+	// fill the transform buffer from the motion states of visible instances and draw
+	void draw(const DrawPacket& packet);
+
+	// number of instances drawn
+	size_t size() const;
+
+	// true if the context can draw instances with per instance attributes
+	static bool supported();
+
+private:
+	// member variables, the batch does not own its instances
+	GLuint program;
+	std::vector<SimObject*> instances;
+	std::vector<GLfloat> transforms;
+	ObjectUniforms uniforms;
+	GLuint vao, instanceBuffer;
+
+	// OpenGL variable locations
+	GLint loc_instanced;
+	GLint loc_model;
+};
+
+#endif // INSTANCE_BATCH_H
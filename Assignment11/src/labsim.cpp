@@ -0,0 +1,187 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <numeric>
+
+#include "labyrinthbatch.h"
+#include "geometryloader.h"
+
+// board angles of the scripted sway, the same path the benchmark uses
+static void sway(float t, float& angle, float& angle2)
+{
+	angle = 0.2f * std::sin(t);
+	angle2 = 0.2f * std::sin(0.7f * t);
+}
+
+// time the same many-ball scene on the single threaded world, then on Bullet's multithreaded
+// world with 1, 2, 4... threads up to the core count, printing one CSV row per run
+static int threadScaling(const LabyrinthAssets& assets, int ballCount, int simulationRate, float seconds)
+{
+	// thread counts to run, 0 is the single threaded world
+	std::vector<int> counts(1, 0);
+	int cores = std::max(1u, std::thread::hardware_concurrency());
+	for(int n = 1; n < cores; n *= 2) {
+		counts.push_back(n);
+	}
+	counts.push_back(cores);
+
+	const float step = 1.0f / simulationRate;
+	const long steps = std::max(1L, std::lround(seconds * simulationRate));
+	std::cout << "Timing " << steps << " steps of 1/" << simulationRate << " s with "
+			  << Labyrinth::OBJECT_COUNT + ballCount << " bodies per run" << std::endl;
+	std::cout << "world,threads,average ms,99th percentile ms,speedup" << std::endl;
+
+	double baseline = 0.0;
+	for(int count : counts) {
+		Labyrinth::physicsThreads = count;
+		Labyrinth labyrinth(assets, ballCount);
+		int threads = Labyrinth::getPhysicsThreadCount();
+		if(count > 0 && threads == 0)
+			return 1;
+
+		// sway the board along the benchmark path and time every step on its own
+		std::vector<double> times;
+		times.reserve(steps);
+		float angle = 0.0f, angle2 = 0.0f;
+		for(long i = 0; i < steps; i++) {
+			float nextAngle, nextAngle2;
+			sway((i + 1) * step, nextAngle, nextAngle2);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			labyrinth.step(step, nextAngle - angle, nextAngle2 - angle2);
+			auto end = std::chrono::high_resolution_clock::now();
+			times.push_back(std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end-start).count());
+
+			angle = nextAngle;
+			angle2 = nextAngle2;
+		}
+
+		// average and 99th percentile, speedup against the single threaded world
+		double average = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+		std::sort(times.begin(), times.end());
+		double percentile = times[std::min(times.size() - 1, size_t(times.size() * 0.99))];
+		if(count == 0)
+			baseline = average;
+
+		std::cout << (count ? "multithreaded," : "single threaded,") << (count ? threads : 1) << ","
+				  << average << "," << percentile << "," << (average > 0.0 ? baseline / average : 0.0) << std::endl;
+	}
+
+	return 0;
+}
+
+// program start
+int main(int argc, char **argv)
+{
+	float seconds = -1.0f;
+	int simulationRate = 120;
+	int ballCount = -1;
+	bool scaling = false;
+	int worldCount = 1;
+	unsigned int threadCount = std::thread::hardware_concurrency();
+
+	// parse command line options, the model options match the game's
+	for(int i = 1; i < argc; i++) {
+		std::string option(argv[i]);
+
+		if(option == "--seconds" && i+1 < argc)
+			seconds = std::max(0.0f, float(std::atof(argv[++i])));
+		else if(option == "--hz" && i+1 < argc)
+			simulationRate = std::max(1, std::atoi(argv[++i]));
+		else if(option == "--balls" && i+1 < argc)
+			ballCount = std::max(0, std::atoi(argv[++i]));
+		else if(option == "--physics-threads" && i+1 < argc)
+			Labyrinth::physicsThreads = std::max(0, std::atoi(argv[++i]));
+		else if(option == "--thread-scaling")
+			scaling = true;
+		else if(option == "--worlds" && i+1 < argc)
+			worldCount = std::max(1, std::atoi(argv[++i]));
+		else if(option == "--threads" && i+1 < argc)
+			threadCount = std::max(1, std::atoi(argv[++i]));
+		else if(option == "--collision-hulls")
+			PhysicsAsset::collisionHulls = true;
+		else if(option == "--shape-cache")
+			PhysicsAsset::serializedShapes = true;
+		else if(option == "--flat-geometry")
+			GeometryLoader::indexedGeometry = false;
+		else if(option == "--rebuild-cache")
+			MeshCache::rebuild = true;
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--seconds N] [--hz N] [--balls N] [--worlds N] [--threads N]"
+					  << " [--physics-threads N] [--thread-scaling]"
+					  << " [--collision-hulls] [--shape-cache] [--flat-geometry] [--rebuild-cache]" << std::endl;
+			return 1;
+		}
+	}
+
+	// the scaling scene is shorter and fuller by default and collides against hulls,
+	// which unlike the board's triangles can collide on several threads at once
+	if(seconds < 0.0f)
+		seconds = scaling ? 10.0f : 60.0f;
+	if(ballCount < 0)
+		ballCount = scaling ? 2000 : 0;
+	if(scaling) {
+		PhysicsAsset::collisionHulls = true;
+		return threadScaling(LabyrinthAssets::load(), ballCount, simulationRate, seconds);
+	}
+
+	// build the worlds without a window or OpenGL context
+	LabyrinthBatch batch(LabyrinthAssets::load(), worldCount, ballCount, threadCount);
+
+	const float step = 1.0f / simulationRate;
+	const long steps = std::lround(seconds * simulationRate);
+	std::cout << "Simulating " << seconds << " s in " << steps << " steps of 1/" << simulationRate << " s with "
+			  << batch.getWorld(0).getBodies().size() << " bodies in " << worldCount << " worlds on "
+			  << batch.getThreadCount() << " threads" << std::endl;
+
+	// sway every board so the balls keep rolling, each world a second further along the path,
+	// and step as fast as possible
+	std::vector<float> angles(2 * worldCount, 0.0f), tilts(2 * worldCount);
+	auto start = std::chrono::high_resolution_clock::now();
+	for(long i = 0; i < steps; i++) {
+		for(int w = 0; w < worldCount; w++) {
+			float nextAngle, nextAngle2;
+			sway((i + 1) * step + w, nextAngle, nextAngle2);
+			tilts[2*w] = nextAngle - angles[2*w];
+			tilts[2*w+1] = nextAngle2 - angles[2*w+1];
+			angles[2*w] = nextAngle;
+			angles[2*w+1] = nextAngle2;
+		}
+		batch.step(step, tilts.data());
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	// steps per second of wall time and how much faster than the game that is, counting every world
+	double ms = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end-start).count();
+	double stepsPerSecond = ms > 0.0 ? steps * double(worldCount) * 1000.0 / ms : 0.0;
+	std::cout << "Wall time: " << ms << " ms, " << stepsPerSecond << " steps/s, "
+			  << stepsPerSecond / simulationRate << "x real time" << std::endl;
+
+	// where the balls ended up, read back the way a controller would
+	std::vector<float> positions(3 * worldCount);
+	batch.observe(positions.data(), nullptr, nullptr);
+	int onBoard = 0;
+	for(int w = 0; w < worldCount; w++) {
+		if(positions[3*w+1] > -1.0f)
+			onBoard++;
+	}
+	std::cout << "Balls on the board: " << onBoard << " of " << worldCount << std::endl;
+
+	// final state, equal checksums mean two builds simulated the same,
+	// with several worlds their checksums are folded into one
+	const Labyrinth& first = batch.getWorld(0);
+	uint32_t checksum = first.checksum();
+	for(int w = 1; w < worldCount; w++) {
+		checksum = (checksum ^ batch.getWorld(w).checksum()) * 16777619u;
+	}
+	std::cout << "Fail count: " << first.getGameScore() << ", best: " << first.getTopTenScores()[0] << std::endl;
+	std::cout << "Checksum: " << std::hex << std::setw(8) << std::setfill('0') << checksum << std::endl;
+
+	return 0;
+}
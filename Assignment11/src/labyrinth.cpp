@@ -0,0 +1,362 @@
+#include "labyrinth.h"
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+int Labyrinth::physicsThreads = 0;
+
+LabyrinthAssets LabyrinthAssets::load()
+{
+	LabyrinthAssets assets;
+	assets.board = std::make_shared<PhysicsAsset>("board.obj");
+	assets.ball = std::make_shared<PhysicsAsset>("ball.obj");
+	assets.cover = std::make_shared<PhysicsAsset>("boardTop.obj");
+	return assets;
+}
+
+// constructor
+Labyrinth::Labyrinth(const LabyrinthAssets& assets, int ballCount)
+	: assets(assets), boardAngle(0), boardAngle2(0), gameTime(0), gameScore(0), topTenScores(10)
+{
+	// initialize physics engine
+	initPhysics();
+
+	// create board, ball and cover
+	bodies.push_back(new PhysicsBody(assets.board->getShape(), 0, btVector3(0,0,0)));
+	bodies.push_back(new PhysicsBody(assets.ball->getShape(), 1, btVector3(0,0.1,0)));
+	bodies.push_back(new PhysicsBody(assets.cover->getShape(), 0, btVector3(0,0.1,0)));
+
+	// set up board as kinematic object
+	bodies[0]->getMesh()->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
+	bodies[2]->getMesh()->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
+
+	// add objects to the simulation enviornment
+	for(PhysicsBody *body : bodies) {
+		simulation->addRigidBody(body->getMesh());
+	}
+
+	// stack extra balls in layers over the middle of the board
+	const int perRow = 17;
+	const float spacing = 0.5f;
+	for(int i = 0; i < ballCount; i++) {
+		int row = i % (perRow * perRow);
+		btVector3 pos((row % perRow - perRow / 2) * spacing,
+					  1.0f + (i / (perRow * perRow)) * spacing,
+					  (row / perRow - perRow / 2) * spacing);
+
+		PhysicsBody *ball = new PhysicsBody(assets.ball->getShape(), 1, pos);
+		ball->setScoring(false);
+		simulation->addRigidBody(ball->getMesh());
+		bodies.push_back(ball);
+	}
+
+	// initialize top scores
+	for(int i = 1; i <= 10; i++) {
+			topTenScores[i-1] = std::string("Time: 0.00   Fail Count: 0");
+	}
+}
+
+// destructor
+Labyrinth::~Labyrinth()
+{
+	// take bodies out of the world before deleting either
+	for(PhysicsBody *body : bodies) {
+		simulation->removeRigidBody(body->getMesh());
+		delete body;
+	}
+
+	delete simulation;
+	delete solver;
+	delete solverPool;
+	delete dispatcher;
+	delete collisionConfig;
+	delete broadphase;
+}
+
+void Labyrinth::initPhysics()
+{
+	// initialize all variables for creating a physics simulation
+	broadphase = new btDbvtBroadphase();
+	collisionConfig = new btDefaultCollisionConfiguration();
+	solverPool = nullptr;
+
+	if(physicsThreads > 0 && startTaskScheduler()) {
+		// GImpact triangle shapes lock their mesh data while colliding, so shared triangle shapes
+		// can only collide on one thread, convex hulls are only ever read
+		if(assets.board->getShape()->getShapeType() == GIMPACT_SHAPE_PROXYTYPE
+				|| assets.ball->getShape()->getShapeType() == GIMPACT_SHAPE_PROXYTYPE
+				|| assets.cover->getShape()->getShapeType() == GIMPACT_SHAPE_PROXYTYPE) {
+			std::cerr << "Triangle shapes can't collide in parallel, use collision hulls "
+					  << "to multithread collisions as well as solving" << std::endl;
+			dispatcher = new btCollisionDispatcher(collisionConfig);
+		}
+		else {
+			dispatcher = new btCollisionDispatcherMt(collisionConfig);
+		}
+
+		// islands are solved in parallel by a pool of solvers, large islands by one parallel solver
+		solverPool = new btConstraintSolverPoolMt(BT_MAX_THREAD_COUNT);
+		solver = new btSequentialImpulseConstraintSolverMt();
+
+		// create a physics simulation stepping on the task scheduler's threads
+		simulation = new btDiscreteDynamicsWorldMt(dispatcher, broadphase, solverPool, solver, collisionConfig);
+	}
+	else {
+		dispatcher = new btCollisionDispatcher(collisionConfig);
+		solver = new btSequentialImpulseConstraintSolver();
+
+		// create a physics simulation
+		simulation = new btDiscreteDynamicsWorld(dispatcher, broadphase, solver, collisionConfig);
+	}
+
+	// initialize simulation gravity to -50
+	simulation->setGravity(btVector3(0,-50,0));
+
+	// register GImpact algorithm for collisions
+	btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
+}
+
+bool Labyrinth::startTaskScheduler()
+{
+	// one scheduler for the whole process, Bullet runs all parallel loops on it
+	static btITaskScheduler *scheduler = btCreateDefaultTaskScheduler();
+	if(!scheduler) {
+		std::cerr << "Bullet was built without BT_THREADSAFE, using the single threaded world" << std::endl;
+		physicsThreads = 0;
+		return false;
+	}
+
+	scheduler->setNumThreadsToUse(physicsThreads);
+	btSetTaskScheduler(scheduler);
+	return true;
+}
+
+int Labyrinth::getPhysicsThreadCount()
+{
+	if(physicsThreads <= 0 || !btGetTaskScheduler())
+		return 0;
+
+	return btGetTaskScheduler()->getNumThreadsUsed();
+}
+
+void Labyrinth::step(float dt, float angle, float angle2)
+{
+	stepPhysics(dt, angle, angle2);
+	applyRules(dt);
+}
+
+void Labyrinth::stepPhysics(float dt, float angle, float angle2)
+{
+	// remember where everything was to blend from
+	for(PhysicsBody *body : bodies) {
+		body->beginStep();
+	}
+
+	// tilt the board and step physics, exactly one step without Bullet's own interpolation
+	tiltBoard(angle, angle2);
+	simulation->stepSimulation(dt, 0);
+}
+
+void Labyrinth::applyRules(float dt)
+{
+	for(PhysicsBody *body : bodies) {
+		// get position and test if score needs to be updated
+		auto pos = body->getPosition();
+		if(pos.y() < -15) {
+			if(body->isScoring())
+				score(0);
+			body->reset();
+		}
+		// win position is around -9x and-6.5z
+		pos = body->getPosition();
+		if(body->isScoring() && pos.x() < -9 && (pos.z() <= -6.3 && pos.z() >= -6.7)) {
+			score(1);
+			body->reset();
+		}
+	}
+
+	// add step to game time
+	gameTime += dt;
+}
+
+void Labyrinth::tiltBoard(float angle, float angle2)
+{
+	boardAngle += angle;
+	boardAngle2 += angle2;
+
+    // limit board rotation
+	if(boardAngle > 0.5) boardAngle = 0.5;
+	if(boardAngle < -0.5) boardAngle = -0.5;
+	if(boardAngle2 > 0.5) boardAngle2 = 0.5;
+	if(boardAngle2 < -0.5) boardAngle2 = -0.5;
+
+	// update board and cover with new rotation value
+    btTransform trans;
+    bodies[0]->getMesh()->getMotionState()->getWorldTransform(trans);
+    auto rotation = trans.getRotation();
+    rotation += btQuaternion(btVector3(0,0,1), boardAngle) + btQuaternion(btVector3(1,0,0), boardAngle2);
+    trans.setRotation(rotation);
+    bodies[0]->getMesh()->getMotionState()->setWorldTransform(trans);
+
+	bodies[2]->getMesh()->getMotionState()->getWorldTransform(trans);
+    rotation = trans.getRotation();
+    rotation += btQuaternion(btVector3(0,0,1), boardAngle) + btQuaternion(btVector3(1,0,0), boardAngle2);
+    trans.setRotation(rotation);
+    bodies[2]->getMesh()->getMotionState()->setWorldTransform(trans);
+}
+
+void Labyrinth::setBoardAngles(float angle, float angle2)
+{
+	boardAngle = angle;
+	boardAngle2 = angle2;
+}
+
+void Labyrinth::finish()
+{
+	score(1);
+}
+
+void Labyrinth::restart()
+{
+	// reset game values
+	gameTime = 0.0;
+	gameScore = 0;
+	boardAngle = boardAngle2 = 0.0;
+
+	// reset objects to inital positions
+	reset();
+
+	// reset top ten scores
+	for(int i = 1; i <= 10; i++) {
+		topTenScores[i-1] = std::string("Time: 0.00   Fail Count: 0");
+	}
+}
+
+void Labyrinth::reset()
+{
+	// reset objects to inital positions
+	bodies[0]->rotate(0,btVector3(1,1,1));
+	bodies[2]->rotate(0,btVector3(1,1,1));
+	bodies[1]->reset();
+
+	boardAngle = boardAngle2 = 0;
+}
+
+void Labyrinth::score(int x)
+{
+	if(x == 0) gameScore++;
+	if(x == 1) {
+		// comparator function for sorting scores
+		auto scoreCmp = [](const std::string& str1, const std::string& str2) -> float {
+			std::stringstream ss(str1);
+			std::string timeText;
+			float t1, t2;
+
+			ss >> timeText >> t1;
+			ss.str(str2);
+			ss >> timeText >> t2;
+
+			if(t1 == 0.0 && t2 != 0.0)
+				return t2 < t1;
+
+			if (t1 != 0.0 && t2 == 0.0)
+				return t1 > t2;
+
+			else
+				return t1 < t2;
+		};
+
+		// buffer for score text
+		char buffer[256];
+
+		// load buffer with current values
+		sprintf(buffer, "Time: %.2f   Fail Count: %d", gameTime, gameScore);
+
+		// add score to top ten
+		topTenScores.push_back(std::string(buffer));
+
+		// sort scores
+		std::sort(topTenScores.begin(), topTenScores.end(), scoreCmp);
+
+		// remove 11th score
+		topTenScores.pop_back();
+
+		// reset game values
+		gameTime = 0.0;
+		gameScore = 0;
+
+		// reset board and ball position
+		reset();
+	}
+}
+
+uint32_t Labyrinth::checksum() const
+{
+	// FNV-1a over the bytes of everything a step changes
+	uint32_t hash = 2166136261u;
+	auto add = [&hash](const void *data, size_t size) {
+		const unsigned char *bytes = static_cast<const unsigned char*>(data);
+		for(size_t i = 0; i < size; i++) {
+			hash = (hash ^ bytes[i]) * 16777619u;
+		}
+	};
+
+	for(PhysicsBody *body : bodies) {
+		btTransform trans;
+		body->getMesh()->getMotionState()->getWorldTransform(trans);
+		btQuaternion rotation = trans.getRotation();
+		const btVector3& linear = body->getMesh()->getLinearVelocity();
+		const btVector3& angular = body->getMesh()->getAngularVelocity();
+
+		const btScalar values[13] = {
+			trans.getOrigin().x(), trans.getOrigin().y(), trans.getOrigin().z(),
+			rotation.x(), rotation.y(), rotation.z(), rotation.w(),
+			linear.x(), linear.y(), linear.z(),
+			angular.x(), angular.y(), angular.z()
+		};
+		add(values, sizeof(values));
+	}
+
+	add(&boardAngle, sizeof(boardAngle));
+	add(&boardAngle2, sizeof(boardAngle2));
+	add(&gameTime, sizeof(gameTime));
+	add(&gameScore, sizeof(gameScore));
+	return hash;
+}
+
+const std::vector<PhysicsBody*>& Labyrinth::getBodies() const
+{
+	return bodies;
+}
+
+PhysicsBody* Labyrinth::getBall() const
+{
+	return bodies[1];
+}
+
+float Labyrinth::getBoardAngle() const
+{
+	return boardAngle;
+}
+
+float Labyrinth::getBoardAngle2() const
+{
+	return boardAngle2;
+}
+
+float Labyrinth::getGameTime() const
+{
+	return gameTime;
+}
+
+int Labyrinth::getGameScore() const
+{
+	return gameScore;
+}
+
+const std::vector<std::string>& Labyrinth::getTopTenScores() const
+{
+	return topTenScores;
+}
@@ -0,0 +1,121 @@
+#ifndef LABYRINTH_H
+#define LABYRINTH_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <LinearMath/btThreads.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "physicsasset.h"
+#include "physicsbody.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// collision shapes a labyrinth is built from, any number of worlds can share them
+struct LabyrinthAssets
+{
+	std::shared_ptr<const PhysicsAsset> board, ball, cover;
+
+	// load the models without any OpenGL, the game gets them from the asset registry instead
+	static LabyrinthAssets load();
+};
+
+// the game without its window: Bullet world, board, ball and extra balls,
+// scoring and board control, nothing in here needs OpenGL
+class Labyrinth
+{
+public:
+	// constructor and destructor, extra balls are stacked over the board and never score
+	Labyrinth(const LabyrinthAssets& assets, int ballCount = 0);
+	~Labyrinth();
+	Labyrinth(const Labyrinth& other) = delete;
+
+	// one fixed step, tilting the board by the given angles first
+	void step(float dt, float angle = 0.0f, float angle2 = 0.0f);
+
+	// the two halves of a step, split so they can be timed apart
+	void stepPhysics(float dt, float angle, float angle2);
+	void applyRules(float dt);
+
+	// add to the board angles, both are limited to half a radian each way
+	void tiltBoard(float angle, float angle2);
+
+	// set the angles the next tilt starts from
+	void setBoardAngles(float angle, float angle2);
+
+	// finish the current game as if the ball reached the goal
+	void finish();
+
+	// start over with a fresh time, fail count and top ten
+	void restart();
+
+	// put board and ball back to their starting positions
+	void reset();
+
+	// FNV-1a checksum over the bytes of everything a step changes
+	uint32_t checksum() const;
+
+	// getter functions, bodies are board, ball and cover followed by the extra balls
+	const std::vector<PhysicsBody*>& getBodies() const;
+	PhysicsBody* getBall() const;
+	float getBoardAngle() const;
+	float getBoardAngle2() const;
+	float getGameTime() const;
+	int getGameScore() const;
+	const std::vector<std::string>& getTopTenScores() const;
+
+	// bodies before the extra balls
+	static const int OBJECT_COUNT = 3;
+
+	// threads of Bullet's multithreaded world, 0 keeps the single threaded world,
+	// worlds created afterwards use it
+	static int physicsThreads;
+
+	// threads Bullet's task scheduler actually runs, 0 without a multithreaded world
+	static int getPhysicsThreadCount();
+
+private:
+	// create the Bullet world
+	void initPhysics();
+
+	// set up Bullet's task scheduler for physicsThreads, false if Bullet was built without threads
+	static bool startTaskScheduler();
+
+	// count a fail with 0 or a finished game with 1
+	void score(int x);
+
+	// member variables, the assets keep the shared shapes alive
+	LabyrinthAssets assets;
+	std::vector<PhysicsBody*> bodies;
+	float boardAngle, boardAngle2;
+	float gameTime;
+	int gameScore;
+	std::vector<std::string> topTenScores;
+
+	// physics
+	btBroadphaseInterface *broadphase;
+	btDefaultCollisionConfiguration *collisionConfig;
+	btCollisionDispatcher *dispatcher;
+	btConstraintSolver *solver;
+	btConstraintSolverPoolMt *solverPool;
+	btDiscreteDynamicsWorld *simulation;
+};
+
+#endif // LABYRINTH_H
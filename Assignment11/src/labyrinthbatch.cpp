@@ -0,0 +1,167 @@
+#include "labyrinthbatch.h"
+
+#include <iostream>
+#include <future>
+#include <memory>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+// constructor
+LabyrinthBatch::LabyrinthBatch(const LabyrinthAssets& assets, int worldCount, int ballCount, unsigned int threadCount)
+	: assets(assets), ballCount(ballCount), worlds(std::max(0, worldCount), nullptr),
+	  threads(usableThreads(assets, worldCount, threadCount)), pool(threads)
+{
+	if(worldCount < 1) {
+		std::cerr << "A batch needs at least one world in LabyrinthBatch::LabyrinthBatch()" << std::endl;
+		throw std::runtime_error("Invalid world count");
+	}
+
+	// build the worlds on the workers, each one only touches its own Bullet world
+	reset();
+}
+
+// destructor
+LabyrinthBatch::~LabyrinthBatch()
+{
+	for(Labyrinth *world : worlds) {
+		delete world;
+	}
+}
+
+unsigned int LabyrinthBatch::usableThreads(const LabyrinthAssets& assets, int worldCount, unsigned int threadCount)
+{
+	// hardware_concurrency may not know the core count, and more workers than worlds would idle
+	threadCount = std::max(1u, std::min(threadCount, unsigned(std::max(1, worldCount))));
+
+	// Bullet's task scheduler is shared by the whole process and runs one parallel loop at a time,
+	// so multithreaded worlds take turns and each step spreads over its threads instead
+	if(threadCount > 1 && Labyrinth::physicsThreads > 0) {
+		std::cerr << "Multithreaded physics worlds can't step at the same time, stepping "
+				  << worldCount << " worlds one after another" << std::endl;
+		return 1;
+	}
+
+	// GImpact triangle shapes lock their mesh data while colliding, which races when
+	// worlds on different threads share them, convex hulls are only ever read
+	for(const PhysicsAsset *asset : {assets.board.get(), assets.ball.get(), assets.cover.get()}) {
+		if(threadCount > 1 && asset->getShape()->getShapeType() == GIMPACT_SHAPE_PROXYTYPE) {
+			std::cerr << "Triangle shapes can't be shared between threads, stepping "
+					  << worldCount << " worlds on one thread, use collision hulls to step them in parallel" << std::endl;
+			return 1;
+		}
+	}
+
+	return threadCount;
+}
+
+void LabyrinthBatch::reset(const unsigned char *mask)
+{
+	forEach([this, mask](int i) {
+		if(mask && !mask[i])
+			return;
+
+		delete worlds[i];
+		worlds[i] = nullptr;
+		worlds[i] = new Labyrinth(assets, ballCount);
+	});
+}
+
+void LabyrinthBatch::step(float dt, const float *tilts)
+{
+	forEach([this, dt, tilts](int i) {
+		if(tilts)
+			worlds[i]->step(dt, tilts[2*i], tilts[2*i+1]);
+		else
+			worlds[i]->step(dt);
+	});
+}
+
+void LabyrinthBatch::observe(float *ballPositions, float *ballVelocities, float *boardAngles) const
+{
+	// copying is far cheaper than a step, so it stays on the calling thread
+	for(size_t i = 0; i < worlds.size(); i++) {
+		const Labyrinth *world = worlds[i];
+
+		if(ballPositions) {
+			btVector3 pos = world->getBall()->getPosition();
+			ballPositions[3*i] = pos.x();
+			ballPositions[3*i+1] = pos.y();
+			ballPositions[3*i+2] = pos.z();
+		}
+
+		if(ballVelocities) {
+			const btVector3& velocity = world->getBall()->getMesh()->getLinearVelocity();
+			ballVelocities[3*i] = velocity.x();
+			ballVelocities[3*i+1] = velocity.y();
+			ballVelocities[3*i+2] = velocity.z();
+		}
+
+		if(boardAngles) {
+			boardAngles[2*i] = world->getBoardAngle();
+			boardAngles[2*i+1] = world->getBoardAngle2();
+		}
+	}
+}
+
+void LabyrinthBatch::forEach(const std::function<void(int)>& function)
+{
+	int count = worlds.size();
+
+	// nothing to hand off with a single worker
+	if(threads <= 1) {
+		for(int i = 0; i < count; i++) {
+			function(i);
+		}
+		return;
+	}
+
+	// one contiguous range of worlds per worker, each signalling when it's done
+	std::vector<std::future<void>> done;
+	for(unsigned int t = 0; t < threads; t++) {
+		int begin = count * t / threads;
+		int end = count * (t+1) / threads;
+
+		auto finished = std::make_shared<std::promise<void>>();
+		done.push_back(finished->get_future());
+		pool.enqueue([&function, begin, end, finished]() {
+			try {
+				for(int i = begin; i < end; i++) {
+					function(i);
+				}
+				finished->set_value();
+			}
+			catch(...) {
+				finished->set_exception(std::current_exception());
+			}
+		});
+	}
+
+	// wait for every range before rethrowing, the tasks still use function
+	for(std::future<void>& range : done) {
+		range.wait();
+	}
+	for(std::future<void>& range : done) {
+		range.get();
+	}
+}
+
+int LabyrinthBatch::getWorldCount() const
+{
+	return worlds.size();
+}
+
+unsigned int LabyrinthBatch::getThreadCount() const
+{
+	return threads;
+}
+
+Labyrinth& LabyrinthBatch::getWorld(int index)
+{
+	return *worlds[index];
+}
+
+const Labyrinth& LabyrinthBatch::getWorld(int index) const
+{
+	return *worlds[index];
+}
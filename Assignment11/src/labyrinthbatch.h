@@ -0,0 +1,56 @@
+#ifndef LABYRINTH_BATCH_H
+#define LABYRINTH_BATCH_H
+
+#include <functional>
+#include <vector>
+
+#include "labyrinth.h"
+#include "threadpool.h"
+
+// K independent labyrinths built from one set of collision shapes and stepped in parallel,
+// for running many games at once without graphics, e.g. to tune or train automated players.
+// State goes in and out through contiguous arrays with one row per world, world i at row i.
+class LabyrinthBatch
+{
+public:
+	// constructor and destructor, every world gets the same extra balls,
+	// with one worker per core by default but never more workers than worlds
+	LabyrinthBatch(const LabyrinthAssets& assets, int worldCount, int ballCount = 0,
+		unsigned int threadCount = std::thread::hardware_concurrency());
+	~LabyrinthBatch();
+	LabyrinthBatch(const LabyrinthBatch& other) = delete;
+
+	// rebuild worlds as new, all of them or those with a nonzero entry in mask (one per world),
+	// so a reset world steps exactly like a freshly created one
+	void reset(const unsigned char *mask = nullptr);
+
+	// one fixed step of every world, tilting board i by tilts[2i] and tilts[2i+1] first
+	// like Labyrinth::step, a null array steps without tilting
+	void step(float dt, const float *tilts = nullptr);
+
+	// copy the state of every world: 3 floats of ball position and 3 of ball velocity
+	// per world and the 2 board angles per world, null arrays are skipped
+	void observe(float *ballPositions, float *ballVelocities, float *boardAngles) const;
+
+	// getter functions, worlds are replaced by reset
+	int getWorldCount() const;
+	unsigned int getThreadCount() const;
+	Labyrinth& getWorld(int index);
+	const Labyrinth& getWorld(int index) const;
+
+private:
+	// workers that can step the worlds, triangle shapes can't be shared between threads
+	static unsigned int usableThreads(const LabyrinthAssets& assets, int worldCount, unsigned int threadCount);
+
+	// call function for every world index, one contiguous range per worker, and wait for all of them
+	void forEach(const std::function<void(int)>& function);
+
+	// member variables, the assets keep the shared shapes alive
+	LabyrinthAssets assets;
+	int ballCount;
+	std::vector<Labyrinth*> worlds;
+	unsigned int threads;
+	ThreadPool pool;
+};
+
+#endif // LABYRINTH_BATCH_H
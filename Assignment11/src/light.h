@@ -25,7 +25,7 @@
 class Light {
 public:
 	// constructor and destructor
-	Light(GLuint program, const glm::vec3& pos = glm::vec3(0,0,0));
+	Light(const glm::vec3& pos = glm::vec3(0,0,0));
 	virtual ~Light() {}
 
 	// tracking information
@@ -33,19 +33,14 @@ public:
 	void disableTracking();
 	bool tracking() const;
 
-	// render lighting and update position values
-	virtual void render(bool ambient = true, bool specular = true, bool diffuse = true);
+	// update position values
 	virtual void update();
+	const glm::vec3& getPosition() const;
 
 protected:
 	// member variables
 	glm::vec3 position;
 	SimObject *trackingObject;
-
-	// OpenGL variable locations
-	GLint loc_diffuse, loc_specular, loc_ambient;
-	GLint loc_shininess;
-	GLint loc_lightPos;
 };
 
 #endif // LIGHT_H
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "lightarray.h"
+
+#include <algorithm>
+
+const int LightArray::MAX_LIGHTS;
+
+// constructor
+LightArray::LightArray(GLuint program)
+{
+	// get all uniform locations from OpenGL program, the array location is its first element
+	loc_ambient = glGetUniformLocation(program, "ambient");
+	loc_diffuse = glGetUniformLocation(program, "diffuse");
+	loc_specular = glGetUniformLocation(program, "specular");
+	loc_shininess = glGetUniformLocation(program, "shininess");
+	loc_lightPositions = glGetUniformLocation(program, "lightPositions");
+	loc_lightCount = glGetUniformLocation(program, "lightCount");
+
+	// if any location not found, throw an error
+	if(loc_ambient == -1 || loc_diffuse == -1
+			|| loc_specular == -1 || loc_shininess == -1
+				|| loc_lightPositions == -1 || loc_lightCount == -1) {
+					std::cerr << loc_ambient << "\n"
+							  << loc_diffuse << "\n"
+							  << loc_specular << "\n"
+							  << loc_shininess << "\n"
+							  << loc_lightPositions << "\n"
+							  << loc_lightCount << std::endl;
+
+				  	throw std::runtime_error("Unable to locate objects in LightArray::LightArray");
+	}
+}
+
+void LightArray::render(const std::vector<Light*>& lights, bool ambient, bool specular, bool diffuse)
+{
+	// lighting terms are shared by all lights, on if flag is true, otherwise off
+	float on = ambient ? 1.0f : 0.0f;
+	GLState::uniform4f(loc_ambient, on, on, on, 0.0f);
+
+	on = diffuse ? 1.0f : 0.0f;
+	GLState::uniform4f(loc_diffuse, on, on, on, 0.0f);
+
+	on = specular ? 1.0f : 0.0f;
+	GLState::uniform4f(loc_specular, on, on, on, 0.0f);
+
+	// set shininess value
+	GLState::uniform1f(loc_shininess, 0.9f);
+
+	// upload all light positions with one call
+	int count = std::min(int(lights.size()), MAX_LIGHTS);
+	positions.resize(count * 4);
+	for(int i = 0; i < count; i++) {
+		const glm::vec3& position = lights[i]->getPosition();
+		positions[i*4] = position[0];
+		positions[i*4 + 1] = position[1];
+		positions[i*4 + 2] = position[2];
+		positions[i*4 + 3] = 0.0f;
+	}
+
+	GLState::uniform1i(loc_lightCount, count);
+	if(count > 0)
+		GLState::uniform4fv(loc_lightPositions, count, positions.data());
+}
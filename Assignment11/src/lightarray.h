@@ -0,0 +1,49 @@
+#ifndef LIGHT_ARRAY_H
+#define LIGHT_ARRAY_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "light.h"
+#include "glstate.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// uploads all lights of the scene to the light array of a shader program,
+// which adds up every light in one pass
+class LightArray
+{
+public:
+	// constructor, gets the uniform locations of the program
+	LightArray(GLuint program);
+
+	// upload light positions and shared lighting terms, lights past MAX_LIGHTS are ignored
+	void render(const std::vector<Light*>& lights, bool ambient = true, bool specular = true, bool diffuse = true);
+
+	// size of the light array in bin/shaders/vert.vs
+	static const int MAX_LIGHTS = 64;
+
+private:
+	// positions of the lights in the last upload
+	std::vector<GLfloat> positions;
+
+	// OpenGL variable locations
+	GLint loc_diffuse, loc_specular, loc_ambient;
+	GLint loc_shininess;
+	GLint loc_lightPositions, loc_lightCount;
+};
+
+#endif // LIGHT_ARRAY_H
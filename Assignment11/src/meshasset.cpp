@@ -0,0 +1,116 @@
+#include "meshasset.h"
+#include "assetregistry.h"
+#include "glstate.h"
+
+// constructor
+MeshAsset::MeshAsset(const std::string& modelFile)
+	: PhysicsAsset(modelFile), ml(), vbo(0), ibo(0)
+{
+	// decode textures now so the GL thread only has to upload them
+	for(const std::string& path : geometry.texturePaths)
+		images.push_back(AssetRegistry::decodeTexture(path));
+}
+
+void MeshAsset::upload()
+{
+    // Create a Vertex Buffer object to store this vertex info on the GPU
+    glGenBuffers(1, &vbo);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * geometry.vertexCount, geometry.vertices, GL_STATIC_DRAW);
+
+    // if indexed, store the index buffer as loaded
+    if(geometry.indexCount > 0) {
+        glGenBuffers(1, &ibo);
+        GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, geometry.indexSize() * geometry.indexCount,
+            geometry.indices, GL_STATIC_DRAW);
+        GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+	// upload textures, images already uploaded by another asset are shared
+	for(unsigned int i = 0; i < geometry.texturePaths.size(); i++)
+		ml.loadTexture(geometry.texturePaths[i].c_str(), images[i].get());
+
+	// decoded pixels are no longer needed
+	images.clear();
+}
+
+// destructor
+MeshAsset::~MeshAsset()
+{
+	// release GPU buffers
+	if(vbo)
+		GLState::deleteBuffer(vbo);
+	if(ibo)
+		GLState::deleteBuffer(ibo);
+}
+
+GLuint MeshAsset::getVBO() const
+{
+	return vbo;
+}
+
+GLuint MeshAsset::getIBO() const
+{
+	return ibo;
+}
+
+GLenum MeshAsset::getIndexType() const
+{
+	return geometry.indexType == MeshData::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+GLsizei MeshAsset::getIndexCount() const
+{
+	return geometry.indexCount;
+}
+
+GLsizei MeshAsset::getIndexSize() const
+{
+	return geometry.indexSize();
+}
+
+int MeshAsset::getLodCount() const
+{
+	return geometry.lods.size();
+}
+
+const MeshLod& MeshAsset::getLod(int level) const
+{
+	return geometry.lods.at(level);
+}
+
+const GLfloat* MeshAsset::getBoundsCenter() const
+{
+	return geometry.boundsCenter;
+}
+
+const GLfloat* MeshAsset::getBoundsExtents() const
+{
+	return geometry.boundsExtents;
+}
+
+GLfloat MeshAsset::getBoundsRadius() const
+{
+	return geometry.boundsRadius;
+}
+
+int MeshAsset::getTriangleCount() const
+{
+	return geometry.triangleCount;
+}
+
+int MeshAsset::getTextureCount() const
+{
+	return geometry.textureCount;
+}
+
+GLuint MeshAsset::getTexture(int index) const
+{
+	return ml.getTexture(index);
+}
+
+const Vertex& MeshAsset::getLighting() const
+{
+	return geometry.lighting;
+}
@@ -0,0 +1,64 @@
+#ifndef MESH_ASSET_H
+#define MESH_ASSET_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "vertex.h"
+#include "meshdata.h"
+#include "modelloader.h"
+#include "physicsasset.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// physics asset plus the GL buffers and textures of one model file,
+// shared by every SimObject created from that file
+class MeshAsset : public PhysicsAsset
+{
+public:
+	// constructor does the CPU work (import, decode, collision shape) and
+	// may run on any thread, upload must then be called on the GL thread
+	MeshAsset(const std::string& modelFile);
+	virtual ~MeshAsset();
+	MeshAsset(const MeshAsset& other) = delete;
+
+	// create GL buffers and textures
+	void upload();
+
+	// getter functions
+	GLuint getVBO() const;
+	GLuint getIBO() const;
+	GLenum getIndexType() const;
+	GLsizei getIndexCount() const;
+	GLsizei getIndexSize() const;
+	int getLodCount() const;
+	const MeshLod& getLod(int level) const;
+	const GLfloat* getBoundsCenter() const;
+	const GLfloat* getBoundsExtents() const;
+	GLfloat getBoundsRadius() const;
+	int getTriangleCount() const;
+	int getTextureCount() const;
+	GLuint getTexture(int index) const;
+	const Vertex& getLighting() const;
+
+private:
+	// member variables, the loader keeps the textures
+	ModelLoader ml;
+	std::vector<std::shared_ptr<const TextureImage>> images;
+	GLuint vbo, ibo;
+};
+
+#endif // MESH_ASSET_H
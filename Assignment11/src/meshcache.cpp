@@ -0,0 +1,252 @@
+#include "meshcache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+bool MeshCache::rebuild = false;
+
+// map a whole file read only, returns nullptr on failure
+static void* mapFile(const std::string& file, size_t& size)
+{
+	int fd = ::open(file.c_str(), O_RDONLY);
+	struct stat info;
+	void *mapping = nullptr;
+
+	if(fd < 0)
+		return nullptr;
+
+	if(fstat(fd, &info) == 0 && info.st_size > 0) {
+		size = info.st_size;
+		mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mapping == MAP_FAILED)
+			mapping = nullptr;
+	}
+
+	// mapping stays valid after the descriptor is closed
+	::close(fd);
+	return mapping;
+}
+
+MeshCache::MeshCache()
+	: mapping(nullptr), mappingSize(0)
+{
+}
+
+MeshCache::~MeshCache()
+{
+	if(mapping)
+		munmap(mapping, mappingSize);
+}
+
+bool MeshCache::open(const std::string& modelFile, const MeshBuildSettings& settings)
+{
+	uint64_t time, size, hash;
+
+	// get key of the current model file
+	if(!sourceKey(modelFile, time, size, hash))
+		return false;
+
+	// map cache file
+	mapping = mapFile(cacheName(modelFile), mappingSize);
+	if(!mapping)
+		return false;
+
+	const MeshCacheHeader& header = *static_cast<const MeshCacheHeader*>(mapping);
+	const char *bytes = static_cast<const char*>(mapping);
+
+	// reject truncated files, other versions, other build settings, damaged headers and changed models
+	bool valid = mappingSize >= sizeof(MeshCacheHeader)
+		&& std::memcmp(header.magic, "LMSH", 4) == 0
+		&& header.version == VERSION
+		&& header.settings.indexed == settings.indexed
+		&& header.settings.lodLevels == settings.lodLevels
+		&& header.settings.lodTriangleRatio == settings.lodTriangleRatio
+		&& header.settings.lodMinReduction == settings.lodMinReduction
+		&& (header.indexSize == sizeof(uint16_t) || header.indexSize == sizeof(uint32_t))
+		&& validLods(header)
+		&& header.sourceTime == time && header.sourceSize == size && header.sourceHash == hash
+		&& mappingSize == stringOffset(header) + header.pathLength + header.texturePathLength
+		&& modelFile.compare(0, std::string::npos, bytes + stringOffset(header), header.pathLength) == 0;
+
+	if(!valid) {
+		munmap(mapping, mappingSize);
+		mapping = nullptr;
+		mappingSize = 0;
+	}
+
+	return valid;
+}
+
+void MeshCache::view(MeshData& data) const
+{
+	const MeshCacheHeader& header = *static_cast<const MeshCacheHeader*>(mapping);
+	const char *bytes = static_cast<const char*>(mapping);
+
+	// point geometry into the mapping
+	data.vertices = reinterpret_cast<const Vertex*>(bytes + vertexOffset());
+	data.vertexCount = header.vertexCount;
+	data.indices = header.indexCount ? bytes + indexOffset(header) : nullptr;
+	data.indexCount = header.indexCount;
+	data.indexType = header.indexSize == sizeof(uint16_t) ? MeshData::UINT16 : MeshData::UINT32;
+
+	// copy model information
+	data.triangleCount = header.triangleCount;
+	data.textureCount = header.textureCount;
+	data.lighting = header.lighting;
+
+	// copy levels of detail and bounds
+	data.lods.assign(header.lods, header.lods + header.lodCount);
+	std::copy(header.boundsCenter, header.boundsCenter + 3, data.boundsCenter);
+	std::copy(header.boundsExtents, header.boundsExtents + 3, data.boundsExtents);
+	data.boundsRadius = header.boundsRadius;
+
+	// texture paths are stored null separated
+	const char *paths = bytes + stringOffset(header) + header.pathLength;
+	const char *pathsEnd = paths + header.texturePathLength;
+	data.texturePaths.clear();
+	while(paths < pathsEnd) {
+		data.texturePaths.push_back(std::string(paths));
+		paths += data.texturePaths.back().size() + 1;
+	}
+
+	// geometry is no longer owned by the mesh data
+	data.vertexStorage.clear();
+	data.indexStorage.clear();
+}
+
+bool MeshCache::write(const std::string& modelFile, const MeshData& data, const MeshBuildSettings& settings)
+{
+	MeshCacheHeader header;
+	std::string texturePaths;
+
+	// zero padding so identical models produce identical files
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, "LMSH", 4);
+	header.version = VERSION;
+
+	if(!sourceKey(modelFile, header.sourceTime, header.sourceSize, header.sourceHash))
+		return false;
+
+	for(const std::string& path : data.texturePaths)
+		texturePaths.append(path.c_str(), path.size() + 1);
+
+	// fill model information
+	header.pathLength = modelFile.size();
+	header.settings = settings;
+	header.triangleCount = data.triangleCount;
+	header.textureCount = data.textureCount;
+	header.vertexCount = data.vertexCount;
+	header.indexCount = data.indexCount;
+	header.indexSize = data.indexSize();
+	header.texturePathLength = texturePaths.size();
+	header.lighting = data.lighting;
+
+	// only as many levels of detail as the header holds are kept
+	const size_t maxLods = sizeof(header.lods) / sizeof(header.lods[0]);
+	header.lodCount = std::min(data.lods.size(), maxLods);
+	std::copy(data.lods.begin(), data.lods.begin() + header.lodCount, header.lods);
+	std::copy(data.boundsCenter, data.boundsCenter + 3, header.boundsCenter);
+	std::copy(data.boundsExtents, data.boundsExtents + 3, header.boundsExtents);
+	header.boundsRadius = data.boundsRadius;
+
+	// write to a temporary file and rename so readers never see a partial cache
+	std::string tempName = cacheName(modelFile) + ".tmp";
+	std::ofstream fout(tempName, std::ios::binary | std::ios::trunc);
+	if(!fout) {
+		std::cerr << "Unable to write mesh cache: " << cacheName(modelFile) << std::endl;
+		return false;
+	}
+
+	const char padding[16] = {};
+	fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	fout.write(padding, vertexOffset() - sizeof(header));
+	fout.write(reinterpret_cast<const char*>(data.vertices), sizeof(Vertex) * data.vertexCount);
+	fout.write(static_cast<const char*>(data.indices), header.indexSize * header.indexCount);
+	fout.write(padding, stringOffset(header) - indexOffset(header) - header.indexSize * header.indexCount);
+	fout.write(modelFile.c_str(), modelFile.size());
+	fout.write(texturePaths.c_str(), texturePaths.size());
+	fout.close();
+
+	if(!fout || std::rename(tempName.c_str(), cacheName(modelFile).c_str()) != 0) {
+		std::cerr << "Unable to write mesh cache: " << cacheName(modelFile) << std::endl;
+		std::remove(tempName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::string MeshCache::cacheName(const std::string& modelFile)
+{
+	return modelFile + ".mesh";
+}
+
+bool MeshCache::sourceKey(const std::string& file, uint64_t& time, uint64_t& size, uint64_t& hash)
+{
+	struct stat info;
+	size_t length = 0;
+
+	if(stat(file.c_str(), &info) != 0)
+		return false;
+
+	time = info.st_mtime;
+	size = info.st_size;
+
+	// FNV-1a over the file contents
+	hash = 14695981039346656037ull;
+	const unsigned char *bytes = static_cast<const unsigned char*>(mapFile(file, length));
+	if(!bytes)
+		return size == 0;
+
+	for(size_t i = 0; i < length; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+
+	munmap(const_cast<unsigned char*>(bytes), length);
+	return true;
+}
+
+size_t MeshCache::vertexOffset()
+{
+	// vertices start 16 byte aligned after the header
+	return (sizeof(MeshCacheHeader) + 15) & ~size_t(15);
+}
+
+bool MeshCache::validLods(const MeshCacheHeader& header)
+{
+	if(header.lodCount > sizeof(header.lods) / sizeof(header.lods[0]))
+		return false;
+
+	// indexed geometry is always drawn through at least its full level
+	if(header.indexCount > 0 && header.lodCount == 0)
+		return false;
+
+	// every level has to be whole triangles inside the index block
+	for(uint32_t i = 0; i < header.lodCount; i++) {
+		const MeshLod& lod = header.lods[i];
+		if(lod.indexCount % 3 != 0 || uint64_t(lod.firstIndex) + lod.indexCount > header.indexCount)
+			return false;
+	}
+
+	return true;
+}
+
+size_t MeshCache::indexOffset(const MeshCacheHeader& header)
+{
+	return vertexOffset() + sizeof(Vertex) * header.vertexCount;
+}
+
+size_t MeshCache::stringOffset(const MeshCacheHeader& header)
+{
+	// strings start 16 byte aligned after the indices
+	return (indexOffset(header) + size_t(header.indexSize) * header.indexCount + 15) & ~size_t(15);
+}
@@ -0,0 +1,85 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include "meshdata.h"
+
+// settings the geometry of a cache file was built with, a cache built with other settings is rebuilt
+struct MeshBuildSettings
+{
+	uint32_t indexed;
+	uint32_t lodLevels;
+	float lodTriangleRatio, lodMinReduction;
+};
+
+// header at the start of every binary mesh cache file
+struct MeshCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+
+	// key of the model file the cache was built from
+	uint64_t sourceTime, sourceSize, sourceHash;
+	uint32_t pathLength;
+	MeshBuildSettings settings;
+
+	// model information
+	uint32_t triangleCount, textureCount;
+	uint32_t vertexCount, indexCount, indexSize;
+	uint32_t texturePathLength;
+	Vertex lighting;
+
+	// levels of detail, bounding box and sphere
+	uint32_t lodCount;
+	MeshLod lods[8];
+	float boundsCenter[3];
+	float boundsExtents[3];
+	float boundsRadius;
+};
+
+// memory mapped binary copy of a loaded model, stored next to the model file
+class MeshCache
+{
+public:
+	// constructor and destructor
+	MeshCache();
+	~MeshCache();
+	MeshCache(const MeshCache& other) = delete;
+
+	// map cache file of a model if it still matches the model and was built with the same settings
+	bool open(const std::string& modelFile, const MeshBuildSettings& settings);
+
+	// point mesh data into the mapped file
+	void view(MeshData& data) const;
+
+	// write cache file for a loaded model
+	static bool write(const std::string& modelFile, const MeshData& data, const MeshBuildSettings& settings);
+
+	// name of the cache file belonging to a model
+	static std::string cacheName(const std::string& modelFile);
+
+	// hash and modification time of a file
+	static bool sourceKey(const std::string& file, uint64_t& time, uint64_t& size, uint64_t& hash);
+
+	// ignore existing cache files and rebuild them
+	static bool rebuild;
+
+	static const uint32_t VERSION = 4;
+
+private:
+	// check that the levels of detail lie inside the index block
+	static bool validLods(const MeshCacheHeader& header);
+
+	// offsets of each block inside the file
+	static size_t vertexOffset();
+	static size_t indexOffset(const MeshCacheHeader& header);
+	static size_t stringOffset(const MeshCacheHeader& header);
+
+	// member variables
+	void *mapping;
+	size_t mappingSize;
+};
+
+#endif // MESH_CACHE_H
@@ -0,0 +1,93 @@
+#include "meshdata.h"
+#include "meshcache.h"
+
+#include <cmath>
+#include <algorithm>
+
+MeshData::MeshData()
+	: vertices(nullptr), vertexCount(0), indices(nullptr), indexCount(0),
+	  indexType(UINT32), boundsRadius(0), triangleCount(0), textureCount(0), lighting()
+{
+	boundsCenter[0] = boundsCenter[1] = boundsCenter[2] = 0.0f;
+	boundsExtents[0] = boundsExtents[1] = boundsExtents[2] = 0.0f;
+}
+
+void MeshData::setGeometry(std::vector<Vertex>& geometry, const std::vector<uint32_t>& indexList,
+	const std::vector<MeshLod>& lodList)
+{
+	// take over vertices without copying
+	vertexStorage.swap(geometry);
+	vertices = vertexStorage.data();
+	vertexCount = vertexStorage.size();
+
+	// store indices as 16 bit if every vertex can be addressed
+	indexCount = indexList.size();
+	indexType = vertexCount <= 0xFFFF ? UINT16 : UINT32;
+	indexStorage.resize(indexSize() * indexCount);
+
+	if(indexType == UINT16) {
+		uint16_t *shortIndices = reinterpret_cast<uint16_t*>(indexStorage.data());
+		for(uint32_t i = 0; i < indexCount; i++)
+			shortIndices[i] = uint16_t(indexList[i]);
+	}
+
+	else {
+		uint32_t *intIndices = reinterpret_cast<uint32_t*>(indexStorage.data());
+		for(uint32_t i = 0; i < indexCount; i++)
+			intIndices[i] = indexList[i];
+	}
+
+	indices = indexCount ? indexStorage.data() : nullptr;
+
+	// without simplified levels the whole index list is the only level
+	lods = lodList;
+	if(lods.empty() && indexCount > 0)
+		lods.push_back(MeshLod{0, indexCount});
+
+	computeBounds();
+
+	// geometry is no longer backed by a cache file
+	cache.reset();
+}
+
+void MeshData::computeBounds()
+{
+	float low[3], high[3];
+
+	if(vertexCount == 0)
+		return;
+
+	// center the sphere on the bounding box
+	for(int j = 0; j < 3; j++)
+		low[j] = high[j] = vertices[0].position[j];
+
+	for(uint32_t i = 1; i < vertexCount; i++) {
+		for(int j = 0; j < 3; j++) {
+			low[j] = std::min(low[j], vertices[i].position[j]);
+			high[j] = std::max(high[j], vertices[i].position[j]);
+		}
+	}
+
+	for(int j = 0; j < 3; j++) {
+		boundsCenter[j] = (low[j] + high[j]) * 0.5f;
+		boundsExtents[j] = (high[j] - low[j]) * 0.5f;
+	}
+
+	// radius reaches the farthest vertex
+	float radiusSquared = 0.0f;
+	for(uint32_t i = 0; i < vertexCount; i++) {
+		float distance = 0.0f;
+		for(int j = 0; j < 3; j++) {
+			float offset = vertices[i].position[j] - boundsCenter[j];
+			distance += offset * offset;
+		}
+		radiusSquared = std::max(radiusSquared, distance);
+	}
+
+	boundsRadius = std::sqrt(radiusSquared);
+}
+
+size_t MeshData::indexSize() const
+{
+	return indexType == UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
@@ -0,0 +1,73 @@
+#ifndef MESH_DATA_H
+#define MESH_DATA_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "vertex.h"
+
+class MeshCache;
+
+// range of the index buffer holding one level of detail
+struct MeshLod
+{
+	uint32_t firstIndex;
+	uint32_t indexCount;
+};
+
+// geometry of a model, either owned or viewed inside a mapped mesh cache
+struct MeshData
+{
+	// constructor, only moves are allowed since views point into storage
+	MeshData();
+	MeshData(const MeshData& other) = delete;
+	MeshData(MeshData&& other) = default;
+	MeshData& operator=(MeshData&& other) = default;
+
+	// take over geometry and narrow indices to the smallest type that fits,
+	// every level of detail is a range of the index list
+	void setGeometry(std::vector<Vertex>& geometry, const std::vector<uint32_t>& indexList,
+		const std::vector<MeshLod>& lodList = std::vector<MeshLod>());
+
+	// find the bounding box and sphere of the vertices
+	void computeBounds();
+
+	// width of one index, the renderer maps it to its own index type
+	enum IndexType {
+		UINT16,
+		UINT32
+	};
+
+	// size of a single index in bytes
+	size_t indexSize() const;
+
+	// views used for drawing and collision, indices hold every level of detail
+	const Vertex *vertices;
+	uint32_t vertexCount;
+	const void *indices;
+	uint32_t indexCount;
+	IndexType indexType;
+
+	// levels of detail, the first one is the full mesh
+	std::vector<MeshLod> lods;
+
+	// bounding box half sizes and sphere in model space, both around the same center
+	float boundsCenter[3];
+	float boundsExtents[3];
+	float boundsRadius;
+
+	// model information
+	int triangleCount, textureCount;
+	Vertex lighting;
+	std::vector<std::string> texturePaths;
+
+	// storage behind the views
+	std::vector<Vertex> vertexStorage;
+	std::vector<unsigned char> indexStorage;
+	std::shared_ptr<MeshCache> cache;
+};
+
+#endif // MESH_DATA_H
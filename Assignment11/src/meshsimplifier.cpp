@@ -0,0 +1,252 @@
+#include "meshsimplifier.h"
+
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+#include <algorithm>
+
+namespace {
+
+// symmetric 4x4 matrix measuring squared distance to a set of planes
+struct Quadric
+{
+	Quadric() { std::fill(m, m + 10, 0.0); }
+
+	// add plane ax + by + cz + d = 0 with a weight
+	void addPlane(double a, double b, double c, double d, double weight)
+	{
+		m[0] += weight*a*a; m[1] += weight*a*b; m[2] += weight*a*c; m[3] += weight*a*d;
+		m[4] += weight*b*b; m[5] += weight*b*c; m[6] += weight*b*d;
+		m[7] += weight*c*c; m[8] += weight*c*d;
+		m[9] += weight*d*d;
+	}
+
+	Quadric& operator+=(const Quadric& other)
+	{
+		for(int i = 0; i < 10; i++)
+			m[i] += other.m[i];
+		return *this;
+	}
+
+	// squared distance of a point to every plane of the quadric
+	double error(const double *p) const
+	{
+		double x = p[0], y = p[1], z = p[2];
+		return m[0]*x*x + 2*m[1]*x*y + 2*m[2]*x*z + 2*m[3]*x
+			 + m[4]*y*y + 2*m[5]*y*z + 2*m[6]*y
+			 + m[7]*z*z + 2*m[8]*z
+			 + m[9];
+	}
+
+	double m[10];
+};
+
+// candidate collapse of one vertex into another
+struct Collapse
+{
+	double cost;
+	uint32_t from, to;
+	unsigned int fromStamp, toStamp;
+
+	bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+// weight of planes keeping open edges and texture seams in place
+const double BOUNDARY_WEIGHT = 100.0;
+
+void cross(const double *a, const double *b, double *out)
+{
+	out[0] = a[1]*b[2] - a[2]*b[1];
+	out[1] = a[2]*b[0] - a[0]*b[2];
+	out[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+// unnormalized normal of the triangle a b c
+void triangleNormal(const double *a, const double *b, const double *c, double *out)
+{
+	double ab[3] = {b[0]-a[0], b[1]-a[1], b[2]-a[2]};
+	double ac[3] = {c[0]-a[0], c[1]-a[1], c[2]-a[2]};
+	cross(ab, ac, out);
+}
+
+inline unsigned long long edgeKey(uint32_t a, uint32_t b)
+{
+	return a < b ? (static_cast<unsigned long long>(a) << 32) | b
+				 : (static_cast<unsigned long long>(b) << 32) | a;
+}
+
+} // namespace
+
+std::vector<uint32_t> MeshSimplifier::simplify(const Vertex *vertices, uint32_t vertexCount,
+	const std::vector<uint32_t>& indices, size_t targetTriangles)
+{
+	size_t triangleCount = indices.size() / 3;
+	std::vector<double> positions(vertexCount * 3);
+	std::vector<Quadric> quadrics(vertexCount);
+	std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+	std::vector<uint32_t> triangles(indices);
+	std::vector<bool> alive(triangleCount, true), removed(vertexCount, false);
+	std::vector<unsigned int> stamps(vertexCount, 0);
+	std::unordered_map<unsigned long long, int> edgeUses;
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+	if(triangleCount <= targetTriangles)
+		return indices;
+
+	for(uint32_t i = 0; i < vertexCount; i++)
+		for(int j = 0; j < 3; j++)
+			positions[i*3 + j] = vertices[i].position[j];
+
+	// accumulate the plane of every triangle into its corners, weighted by area
+	for(size_t t = 0; t < triangleCount; t++) {
+		const uint32_t *corner = &triangles[t*3];
+		double normal[3];
+
+		triangleNormal(&positions[corner[0]*3], &positions[corner[1]*3], &positions[corner[2]*3], normal);
+		double length = std::sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+
+		for(int j = 0; j < 3; j++) {
+			vertexTriangles[corner[j]].push_back(t);
+			edgeUses[edgeKey(corner[j], corner[(j+1)%3])]++;
+		}
+
+		if(length <= 0.0)
+			continue;
+
+		double a = normal[0]/length, b = normal[1]/length, c = normal[2]/length;
+		double d = -(a*positions[corner[0]*3] + b*positions[corner[0]*3+1] + c*positions[corner[0]*3+2]);
+		for(int j = 0; j < 3; j++)
+			quadrics[corner[j]].addPlane(a, b, c, d, length * 0.5);
+	}
+
+	// hold edges used by a single triangle in place with a perpendicular plane
+	for(size_t t = 0; t < triangleCount; t++) {
+		const uint32_t *corner = &triangles[t*3];
+		double normal[3];
+
+		triangleNormal(&positions[corner[0]*3], &positions[corner[1]*3], &positions[corner[2]*3], normal);
+
+		for(int j = 0; j < 3; j++) {
+			uint32_t u = corner[j], v = corner[(j+1)%3];
+			if(edgeUses[edgeKey(u, v)] != 1)
+				continue;
+
+			const double *p = &positions[u*3], *q = &positions[v*3];
+			double edge[3] = {q[0]-p[0], q[1]-p[1], q[2]-p[2]}, plane[3];
+			cross(edge, normal, plane);
+
+			double length = std::sqrt(plane[0]*plane[0] + plane[1]*plane[1] + plane[2]*plane[2]);
+			if(length <= 0.0)
+				continue;
+
+			double a = plane[0]/length, b = plane[1]/length, c = plane[2]/length;
+			double d = -(a*p[0] + b*p[1] + c*p[2]);
+			double weight = BOUNDARY_WEIGHT * (edge[0]*edge[0] + edge[1]*edge[1] + edge[2]*edge[2]);
+			quadrics[u].addPlane(a, b, c, d, weight);
+			quadrics[v].addPlane(a, b, c, d, weight);
+		}
+	}
+
+	// queue the cheaper direction of an edge
+	auto pushEdge = [&](uint32_t u, uint32_t v) {
+		Quadric combined = quadrics[u];
+		combined += quadrics[v];
+
+		double toV = combined.error(&positions[v*3]);
+		double toU = combined.error(&positions[u*3]);
+
+		if(toV <= toU)
+			heap.push(Collapse{toV, u, v, stamps[u], stamps[v]});
+		else
+			heap.push(Collapse{toU, v, u, stamps[v], stamps[u]});
+	};
+
+	for(const auto& edge : edgeUses)
+		pushEdge(uint32_t(edge.first >> 32), uint32_t(edge.first & 0xFFFFFFFFu));
+
+	size_t remaining = triangleCount;
+	while(remaining > targetTriangles && !heap.empty()) {
+		Collapse collapse = heap.top();
+		heap.pop();
+
+		// skip collapses whose vertices changed since they were queued
+		if(removed[collapse.from] || removed[collapse.to]
+			|| stamps[collapse.from] != collapse.fromStamp || stamps[collapse.to] != collapse.toStamp)
+			continue;
+
+		uint32_t from = collapse.from, to = collapse.to;
+		bool flips = false;
+
+		// reject collapses that would fold a remaining triangle over
+		for(uint32_t t : vertexTriangles[from]) {
+			uint32_t *corner = &triangles[t*3];
+			if(!alive[t] || corner[0] == to || corner[1] == to || corner[2] == to)
+				continue;
+
+			const double *p[3], *moved[3];
+			for(int j = 0; j < 3; j++) {
+				p[j] = &positions[corner[j]*3];
+				moved[j] = corner[j] == from ? &positions[to*3] : p[j];
+			}
+
+			double before[3], after[3];
+			triangleNormal(p[0], p[1], p[2], before);
+			triangleNormal(moved[0], moved[1], moved[2], after);
+			if(before[0]*after[0] + before[1]*after[1] + before[2]*after[2] <= 0.0) {
+				flips = true;
+				break;
+			}
+		}
+
+		if(flips)
+			continue;
+
+		// move triangles of the collapsed vertex, dropping the ones on the edge
+		for(uint32_t t : vertexTriangles[from]) {
+			uint32_t *corner = &triangles[t*3];
+			if(!alive[t])
+				continue;
+
+			if(corner[0] == to || corner[1] == to || corner[2] == to) {
+				alive[t] = false;
+				remaining--;
+				continue;
+			}
+
+			for(int j = 0; j < 3; j++)
+				if(corner[j] == from)
+					corner[j] = to;
+			vertexTriangles[to].push_back(t);
+		}
+
+		quadrics[to] += quadrics[from];
+		vertexTriangles[from].clear();
+		removed[from] = true;
+		stamps[to]++;
+
+		// forget dead triangles and requeue every edge around the kept vertex
+		std::vector<uint32_t>& around = vertexTriangles[to];
+		around.erase(std::remove_if(around.begin(), around.end(),
+			[&](uint32_t t) { return !alive[t]; }), around.end());
+
+		std::vector<uint32_t> neighbors;
+		for(uint32_t t : around)
+			for(int j = 0; j < 3; j++)
+				if(triangles[t*3 + j] != to)
+					neighbors.push_back(triangles[t*3 + j]);
+
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+		for(uint32_t n : neighbors)
+			pushEdge(n, to);
+	}
+
+	// gather remaining triangles
+	std::vector<uint32_t> result;
+	result.reserve(remaining * 3);
+	for(size_t t = 0; t < triangleCount; t++)
+		if(alive[t])
+			result.insert(result.end(), &triangles[t*3], &triangles[t*3] + 3);
+
+	return result;
+}
@@ -0,0 +1,20 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "vertex.h"
+
+// reduces triangle counts by quadric error edge collapse
+class MeshSimplifier
+{
+public:
+	// collapse edges in order of quadric error until at most targetTriangles remain,
+	// the result indexes the same vertices so every level can share one vertex buffer
+	static std::vector<uint32_t> simplify(const Vertex *vertices, uint32_t vertexCount,
+		const std::vector<uint32_t>& indices, size_t targetTriangles);
+};
+
+#endif // MESH_SIMPLIFIER_H
@@ -10,58 +10,58 @@
 
 #include <GL/glew.h>
 
-#include <iostream>
-#include <fstream>
 #include <string>
 #include <vector>
-#include <deque>
-
-// if using assimp version 2, load different headers
-#ifdef ASSIMP_2
-#include <assimp/assimp.hpp>
-#include <assimp/aiScene.h>
-#include <assimp/aiPostProcess.h>
-#include <assimp/aiTexture.h>
-
-#else // assimp version 3
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-#include <assimp/texture.h>
-#endif
+#include <memory>
 
 #include <FreeImagePlus.h>
 
-#include "vertex.h"
+#include "texturecache.h"
+#include "glstate.h"
 
 // re-enable warnings
 #ifdef __APPLE__
 #pragma clang diagnostic pop
 #endif
 
+// OpenGL texture that is deleted with its last owner
+struct Texture
+{
+	Texture(GLuint texId) : id(texId) {}
+	~Texture() { GLState::deleteTexture(id); }
+	Texture(const Texture& other) = delete;
+
+	GLuint id;
+};
+
+// OpenGL textures of a model, its geometry is loaded by GeometryLoader
 class ModelLoader
 {
 public:
 	// constructor and destructor
-	ModelLoader(const char *objectFile = "model.obj");
+	ModelLoader();
 	~ModelLoader() {}
 
-	// update filename to new name
-	void setFileName(std::string fileName);
+	// used to load texture from file or an already decoded image,
+	// shared through the asset registry
+	void loadTexture(const char *fileName, const TextureImage *image = nullptr);
 
-	// used to load geometry from object file
-	std::vector<Vertex> load(int& numTriangles, int& numTextures, Vertex& light);
+	// used to decode a texture file and build its mip chain through the
+	// texture cache, may run on any thread
+	static bool decodeTexture(const char *fileName, TextureImage& image);
 
-	// used to load texture from file
-	void loadTexture(const char *fileName);
+	// used to upload a decoded texture and its mip chain to OpenGL
+	static GLuint uploadTexture(const TextureImage& image);
 
 	// return textureID	
 	GLuint getTexture(int index) const;
 
+	// maximum anisotropic filtering applied to textures, 1 disables it
+	static float anisotropy;
+
 private:
 	// member variables
-	std::string filename;
-	std::vector<GLuint> textures;
+	std::vector<std::shared_ptr<Texture>> textures;
 };
 
 #endif // MODEL_LOADER_H
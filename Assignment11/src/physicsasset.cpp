@@ -0,0 +1,125 @@
+#include "physicsasset.h"
+#include "geometryloader.h"
+#include "hullcache.h"
+#include "shapecache.h"
+
+#include <chrono>
+
+bool PhysicsAsset::collisionHulls = false;
+bool PhysicsAsset::serializedShapes = false;
+
+// constructor
+PhysicsAsset::PhysicsAsset(const std::string& modelFile)
+	: filename(modelFile), mesh(nullptr), shape(nullptr), importer(nullptr)
+{
+	// load geometry from model file or its mesh cache
+	GeometryLoader loader(modelFile.c_str());
+	loader.load(geometry);
+
+	// Bullet's importer rebuilds the box tree of GImpact triangle shapes on load, on top of copying
+	// the triangles the mesh cache already maps, so only hull shapes are worth serializing
+	bool cached = serializedShapes && collisionHulls;
+	auto start = std::chrono::high_resolution_clock::now();
+	auto elapsed = [&start]() {
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end-start).count();
+	};
+
+	// load the collision shape serialized by an earlier launch
+	if(cached && !MeshCache::rebuild)
+		shape = ShapeCache::read(filename, collisionHulls, importer);
+
+	if(shape) {
+		std::cout << "Shape cache: " << ShapeCache::cacheName(filename) << " loaded in " << elapsed() << " ms" << std::endl;
+		return;
+	}
+
+	// otherwise build it, from the convex decomposition when requested
+	shape = collisionHulls ? createHullShape() : createTriangleShape();
+	if(serializedShapes)
+		std::cout << "Collision shape of " << filename << " built in " << elapsed() << " ms" << std::endl;
+
+	if(cached && ShapeCache::write(filename, collisionHulls, shape))
+		std::cout << "Shape cache written: " << ShapeCache::cacheName(filename) << std::endl;
+}
+
+// destructor
+PhysicsAsset::~PhysicsAsset()
+{
+	// release physics data, loaded shapes belong to their importer
+	if(importer) {
+		importer->deleteAllData();
+		delete importer;
+	}
+
+	else {
+		ConvexDecomposition::deleteShape(shape);
+		delete mesh;
+	}
+}
+
+btCollisionShape* PhysicsAsset::createTriangleShape()
+{
+	// initialize physics mesh
+	if(geometry.indexCount > 0) {
+		// reference positions and indices in place instead of copying them,
+		// collisions always use the full detail level
+		btIndexedMesh part;
+		part.m_numTriangles = geometry.lods[0].indexCount / 3;
+		part.m_triangleIndexBase = static_cast<const unsigned char*>(geometry.indices);
+		part.m_triangleIndexStride = 3 * geometry.indexSize();
+		part.m_numVertices = geometry.vertexCount;
+		part.m_vertexBase = reinterpret_cast<const unsigned char*>(geometry.vertices[0].position);
+		part.m_vertexStride = sizeof(Vertex);
+		part.m_indexType = geometry.indexType == MeshData::UINT16 ? PHY_SHORT : PHY_INTEGER;
+		part.m_vertexType = PHY_FLOAT;
+
+		btTriangleIndexVertexArray *indexedMesh = new btTriangleIndexVertexArray();
+		indexedMesh->addIndexedMesh(part, part.m_indexType);
+		mesh = indexedMesh;
+	}
+
+	else {
+		btTriangleMesh *triangleMesh = new btTriangleMesh();
+		const Vertex *v = geometry.vertices;
+		for(unsigned int i = 0; i < geometry.vertexCount; i+=3) {
+			triangleMesh->addTriangle(btVector3(v[i].position[0], v[i].position[1], v[i].position[2]),
+								  btVector3(v[i+1].position[0], v[i+1].position[1], v[i+1].position[2]),
+								  btVector3(v[i+2].position[0], v[i+2].position[1], v[i+2].position[2]));
+		}
+		mesh = triangleMesh;
+	}
+
+	// initialize collision shape, shared by every body using this asset
+	btGImpactMeshShape *triangleShape = new btGImpactMeshShape(mesh);
+	triangleShape->setLocalScaling(btVector3(1.0,1.0,1.0));
+	triangleShape->updateBound();
+	return triangleShape;
+}
+
+btCollisionShape* PhysicsAsset::createHullShape() const
+{
+	ConvexHulls hulls;
+
+	// build and store hulls if the model has none or changed since
+	if(MeshCache::rebuild || !HullCache::read(filename, hulls)) {
+		ConvexDecomposition::Settings settings;
+		hulls = ConvexDecomposition::decompose(geometry, settings);
+
+		if(HullCache::write(filename, hulls, settings))
+			std::cout << "Hull cache written: " << HullCache::cacheName(filename) << std::endl;
+	}
+
+	std::cout << "Collision hulls: " << filename << " " << hulls.size() << std::endl;
+	return ConvexDecomposition::createShape(hulls);
+}
+
+const std::string& PhysicsAsset::getFileName() const
+{
+	return filename;
+}
+
+btCollisionShape* PhysicsAsset::getShape() const
+{
+	return shape;
+}
@@ -0,0 +1,63 @@
+#ifndef PHYSICS_ASSET_H
+#define PHYSICS_ASSET_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/Gimpact/btGImpactShape.h>
+
+#include <string>
+
+#include "meshdata.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+class btBulletWorldImporter;
+
+// geometry and collision shape of one model file, shared by every body created
+// from that file, loading it never needs an OpenGL context
+class PhysicsAsset
+{
+public:
+	// constructor does all the work (import, collision shape) and may run on any thread
+	PhysicsAsset(const std::string& modelFile);
+	virtual ~PhysicsAsset();
+	PhysicsAsset(const PhysicsAsset& other) = delete;
+
+	// getter functions
+	const std::string& getFileName() const;
+	btCollisionShape* getShape() const;
+
+	// use convex hulls from the hull cache instead of the render triangles for collisions
+	static bool collisionHulls;
+
+	// load collision shapes from .bullet caches instead of building them
+	static bool serializedShapes;
+
+protected:
+	// build a GImpact shape over the render triangles
+	btCollisionShape* createTriangleShape();
+
+	// load or build the convex decomposition of the model
+	btCollisionShape* createHullShape() const;
+
+	// member variables
+	std::string filename;
+	MeshData geometry;
+
+	// physics variables, the mesh is only used by triangle shapes
+	// and the importer owns shapes loaded from the shape cache
+	btStridingMeshInterface *mesh;
+	btCollisionShape *shape;
+	btBulletWorldImporter *importer;
+};
+
+#endif // PHYSICS_ASSET_H
@@ -0,0 +1,124 @@
+#include "physicsbody.h"
+
+// constructor
+PhysicsBody::PhysicsBody(btCollisionShape *shape, btScalar mass, btVector3 vec)
+	: start(vec), scoring(true)
+{
+	btDefaultMotionState* fallMotionState = new btDefaultMotionState(btTransform(btQuaternion(0,0,0,1), vec));
+	btVector3 fallInertia(0,0,0);
+	if(mass > 0) {
+		shape->calculateLocalInertia(mass, fallInertia);
+	}
+	shape->calculateLocalInertia(mass, fallInertia);
+	btRigidBody::btRigidBodyConstructionInfo shape1CI(mass,fallMotionState,shape,fallInertia);
+	shape1CI.m_friction = 0.5;
+	//shape1CI.m_restitution = 0.0;
+
+	// create rigid body from collision shape
+	meshBody = new btRigidBody(shape1CI);
+
+	// disable object from deactivating
+	meshBody->setActivationState(DISABLE_DEACTIVATION);
+
+	// nothing to blend from before the first step
+	beginStep();
+}
+
+// destructor
+PhysicsBody::~PhysicsBody()
+{
+	delete meshBody->getMotionState();
+	delete meshBody;
+}
+
+void PhysicsBody::move(btVector3 pos)
+{
+	// get transform and update with new position
+    btTransform trans;
+    meshBody->getMotionState()->getWorldTransform(trans);
+    trans.setOrigin(pos);
+
+    // update body with new transform, jumping there instead of blending
+    meshBody->getMotionState()->setWorldTransform(trans);
+    meshBody->setCenterOfMassTransform(trans);
+    previous = trans;
+}
+
+void PhysicsBody::rotate(float angle, btVector3 y)
+{
+	// get transform and update with new rotation
+    btTransform trans;
+    meshBody->getMotionState()->getWorldTransform(trans);
+    trans.setRotation(btQuaternion(y, angle));
+
+    // update body with new transform, jumping there instead of blending
+    meshBody->getMotionState()->setWorldTransform(trans);
+    meshBody->setCenterOfMassTransform(trans);
+    previous = trans;
+}
+
+void PhysicsBody::reset()
+{
+	// disable all movement
+	meshBody->setLinearVelocity(btVector3(0,0,0));
+	meshBody->setAngularVelocity(btVector3(0,0,0));
+
+	// reset position
+	move(start);
+}
+
+void PhysicsBody::setScoring(bool enabled)
+{
+	scoring = enabled;
+}
+
+bool PhysicsBody::isScoring() const
+{
+	return scoring;
+}
+
+btRigidBody* PhysicsBody::getMesh() const
+{
+	return meshBody;
+}
+
+btVector3 PhysicsBody::getPosition() const
+{
+	// get transform and return position from it
+	btTransform trans;
+	meshBody->getMotionState()->getWorldTransform(trans);
+	return trans.getOrigin();
+}
+
+void PhysicsBody::beginStep()
+{
+	meshBody->getMotionState()->getWorldTransform(previous);
+}
+
+glm::mat4 PhysicsBody::getWorldMatrix(float alpha) const
+{
+    float m[16];
+    btTransform trans;
+    glm::mat4 glMat;
+
+    // get objects position in the world
+    meshBody->getMotionState()->getWorldTransform(trans);
+
+    // blend from the previous step, moving straight and turning at an even rate
+    if(alpha < 1.0f) {
+        trans.setOrigin(previous.getOrigin().lerp(trans.getOrigin(), alpha));
+        trans.setRotation(previous.getRotation().slerp(trans.getRotation(), alpha));
+    }
+
+    // get openGL matrix from world
+	trans.getOpenGLMatrix(m);
+
+	// load OpenGL matrix into glm matrix
+	int k = 0;
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++) {
+			glMat[i][j] = m[k++];
+		}
+
+	return glMat;
+}
@@ -0,0 +1,56 @@
+#ifndef PHYSICS_BODY_H
+#define PHYSICS_BODY_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <glm/glm.hpp>
+
+#include <btBulletDynamicsCommon.h>
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// rigid body of one object in the simulation, drawn by a SimObject through snapshots
+class PhysicsBody
+{
+public:
+	// constructor and destructor, the body has to be removed from its world first
+	PhysicsBody(btCollisionShape *shape, btScalar mass = 1, btVector3 vec = btVector3(0,0,0));
+	~PhysicsBody();
+	PhysicsBody(const PhysicsBody& other) = delete;
+
+	// functions to update the body
+	void move(btVector3 pos = btVector3(0,0,0));
+	void rotate(float angle, btVector3 y = btVector3(0,1,0));
+	void reset();
+
+	// bodies that don't score only reset when they fall off
+	void setScoring(bool enabled);
+	bool isScoring() const;
+
+	// getter functions
+	btRigidBody* getMesh() const;
+	btVector3 getPosition() const;
+
+	// keep the transform from before a fixed simulation step
+	void beginStep();
+
+	// model matrix of the rigid body between the last two steps, 0 is the previous and 1 the latest
+	glm::mat4 getWorldMatrix(float alpha = 1.0f) const;
+
+private:
+	// member variables
+	btRigidBody *meshBody;
+	btTransform previous;
+	btVector3 start;
+	bool scoring;
+};
+
+#endif // PHYSICS_BODY_H
@@ -0,0 +1,233 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+// constructor
+CpuTimer::CpuTimer(float& ms)
+	: ms(ms), start(std::chrono::high_resolution_clock::now())
+{
+}
+
+// destructor
+CpuTimer::~CpuTimer()
+{
+	auto end = std::chrono::high_resolution_clock::now();
+	ms = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(end-start).count();
+}
+
+const int Profiler::HISTORY;
+
+// constructor
+Profiler::Profiler()
+	: gpuTiming(supported()), frame(0), frameNumber(0), logging(false)
+{
+	for(History& history : histories) {
+		history.samples.resize(HISTORY);
+		history.count = history.next = 0;
+	}
+
+	// a query per GPU section for each frame in flight
+	for(int i = 0; i < QUERY_FRAMES; i++) {
+		for(int j = 0; j < GPU_SECTIONS; j++) {
+			queries[i][j] = 0;
+			issued[i][j] = -1;
+		}
+		if(gpuTiming)
+			glGenQueries(GPU_SECTIONS, queries[i]);
+	}
+}
+
+// destructor
+Profiler::~Profiler()
+{
+	if(gpuTiming) {
+		for(int i = 0; i < QUERY_FRAMES; i++) {
+			glDeleteQueries(GPU_SECTIONS, queries[i]);
+		}
+	}
+}
+
+void Profiler::record(Section section, float ms)
+{
+	History& history = histories[section];
+	history.samples[history.next] = ms;
+	history.next = (history.next + 1) % HISTORY;
+	history.count = std::min(history.count + 1, HISTORY);
+}
+
+void Profiler::beginGpu(Section section)
+{
+	if(!gpuTiming)
+		return;
+
+	// the query of this slot was issued a few frames ago, take its result if the GPU is done
+	int slot = section - GPU_SCENE;
+	readQuery(frame, slot, logging);
+
+	glBeginQuery(GL_TIME_ELAPSED, queries[frame][slot]);
+	issued[frame][slot] = frameNumber;
+}
+
+void Profiler::endGpu()
+{
+	if(gpuTiming)
+		glEndQuery(GL_TIME_ELAPSED);
+}
+
+void Profiler::endFrame()
+{
+	frame = (frame + 1) % QUERY_FRAMES;
+	frameNumber++;
+}
+
+void Profiler::enableFrameLog()
+{
+	logging = true;
+}
+
+void Profiler::finish()
+{
+	if(!gpuTiming)
+		return;
+
+	for(int i = 0; i < QUERY_FRAMES; i++) {
+		for(int j = 0; j < GPU_SECTIONS; j++) {
+			readQuery(i, j, true);
+		}
+	}
+}
+
+float Profiler::getFrameTime(Section section, int frame) const
+{
+	const std::vector<float>& log = frameLog[section - GPU_SCENE];
+	return frame < int(log.size()) ? log[frame] : -1.0f;
+}
+
+Profiler::Stats Profiler::getStats(Section section) const
+{
+	const History& history = histories[section];
+	return computeStats(std::vector<float>(history.samples.begin(), history.samples.begin() + history.count));
+}
+
+Profiler::Stats Profiler::computeStats(std::vector<float> sorted)
+{
+	if(sorted.empty())
+		return Stats{0.0f, 0.0f, 0.0f};
+
+	std::sort(sorted.begin(), sorted.end());
+
+	float sum = 0.0f;
+	for(float ms : sorted) {
+		sum += ms;
+	}
+
+	// smallest sample at least 99% of the others don't exceed
+	int p99 = std::max(0, int(std::ceil(0.99f * sorted.size())) - 1);
+	return Stats{sorted.front(), sum / sorted.size(), sorted[p99]};
+}
+
+const char* Profiler::getName(Section section)
+{
+	static const char *names[SECTION_COUNT] = {
+		"Input", "Physics", "Objects", "Lights", "Culling",
+		"Submit", "HUD", "Frame", "GPU scene", "GPU HUD"
+	};
+	return names[section];
+}
+
+void Profiler::renderGraph(glm::vec2 low, glm::vec2 high, float maxMs) const
+{
+	// fixed function lines in screen coordinates, untextured and on top of the scene
+	GLState::useProgram(0);
+	glDisable(GL_TEXTURE_2D);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// dark background
+	glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
+	glBegin(GL_QUADS);
+	glVertex2f(low.x, low.y);
+	glVertex2f(high.x, low.y);
+	glVertex2f(high.x, high.y);
+	glVertex2f(low.x, high.y);
+	glEnd();
+
+	// 60 and 30 frames per second budgets
+	glColor4f(1.0f, 1.0f, 1.0f, 0.5f);
+	glBegin(GL_LINES);
+	for(float budget : {1000.0f / 60.0f, 1000.0f / 30.0f}) {
+		if(budget < maxMs) {
+			float y = low.y + (high.y - low.y) * budget / maxMs;
+			glVertex2f(low.x, y);
+			glVertex2f(high.x, y);
+		}
+	}
+	glEnd();
+
+	// frame time in yellow, GPU scene time in green
+	glColor4f(1.0f, 1.0f, 0.0f, 1.0f);
+	renderLine(histories[FRAME], low, high, maxMs);
+	glColor4f(0.0f, 1.0f, 0.0f, 1.0f);
+	renderLine(histories[GPU_SCENE], low, high, maxMs);
+
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_TEXTURE_2D);
+}
+
+bool Profiler::supported()
+{
+	// elapsed time queries with 64 bit results
+	return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
+
+void Profiler::readQuery(int queryFrame, int slot, bool wait)
+{
+	int issuedFrame = issued[queryFrame][slot];
+	if(issuedFrame < 0)
+		return;
+
+	GLuint query = queries[queryFrame][slot];
+	if(!wait) {
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if(!available)
+			return;
+	}
+
+	GLuint64 ns = 0;
+	glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+	float ms = ns / 1000000.0f;
+	issued[queryFrame][slot] = -1;
+
+	// the first query of a context can count its start up on some drivers
+	if(issuedFrame > 0)
+		record(Section(GPU_SCENE + slot), ms);
+
+	if(logging) {
+		std::vector<float>& log = frameLog[slot];
+		if(int(log.size()) <= issuedFrame)
+			log.resize(issuedFrame + 1, -1.0f);
+		log[issuedFrame] = ms;
+	}
+}
+
+void Profiler::renderLine(const History& history, glm::vec2 low, glm::vec2 high, float maxMs) const
+{
+	if(history.count < 2)
+		return;
+
+	// oldest sample sits where the ring will write next once it is full
+	int first = history.count < HISTORY ? 0 : history.next;
+	float step = (high.x - low.x) / (HISTORY - 1);
+
+	glBegin(GL_LINE_STRIP);
+	for(int i = 0; i < history.count; i++) {
+		float ms = std::min(history.samples[(first + i) % HISTORY], maxMs);
+		glVertex2f(low.x + i * step, low.y + (high.y - low.y) * ms / maxMs);
+	}
+	glEnd();
+}
@@ -0,0 +1,131 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <vector>
+
+#include "glstate.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// writes the milliseconds between its construction and destruction to a float
+class CpuTimer
+{
+public:
+	CpuTimer(float& ms);
+	~CpuTimer();
+	CpuTimer(const CpuTimer& other) = delete;
+
+private:
+	float& ms;
+	std::chrono::time_point<std::chrono::high_resolution_clock> start;
+};
+
+// keeps recent CPU and GPU times of each part of a frame,
+// GPU times come from timer queries read back a few frames late so nothing waits on them
+class Profiler
+{
+public:
+	// parts of a frame, GPU sections come last
+	enum Section {
+		INPUT,
+		PHYSICS,
+		OBJECTS,
+		LIGHTS,
+		CULLING,
+		SUBMIT,
+		HUD,
+		FRAME,
+		GPU_SCENE,
+		GPU_HUD,
+		SECTION_COUNT
+	};
+
+	// rolling statistics of one section in milliseconds
+	struct Stats
+	{
+		float min, avg, p99;
+	};
+
+	// constructor and destructor
+	Profiler();
+	~Profiler();
+	Profiler(const Profiler& other) = delete;
+
+	// add a CPU time
+	void record(Section section, float ms);
+
+	// bracket GPU work, sections can't overlap
+	void beginGpu(Section section);
+	void endGpu();
+
+	// move on to the next set of queries
+	void endFrame();
+
+	// keep the GPU time of every frame for benchmarks, results are then waited for
+	// when their query is needed again instead of being skipped
+	void enableFrameLog();
+
+	// wait for all queries still in flight
+	void finish();
+
+	// logged GPU time of a frame, negative if there is none
+	float getFrameTime(Section section, int frame) const;
+
+	// statistics over the recent history, zero without samples
+	Stats getStats(Section section) const;
+	static Stats computeStats(std::vector<float> samples);
+	static const char* getName(Section section);
+
+	// draw frame and GPU scene times as lines between two screen corners
+	void renderGraph(glm::vec2 low, glm::vec2 high, float maxMs) const;
+
+	// true if the context has timer queries
+	static bool supported();
+
+private:
+	// samples kept per section and frames a query result may take
+	static const int HISTORY = 240;
+	static const int QUERY_FRAMES = 4;
+	static const int GPU_SECTIONS = SECTION_COUNT - GPU_SCENE;
+
+	// ring of recent samples
+	struct History
+	{
+		std::vector<float> samples;
+		int count, next;
+	};
+
+	// draw one history as a line strip, oldest sample on the left
+	void renderLine(const History& history, glm::vec2 low, glm::vec2 high, float maxMs) const;
+
+	// record the result of a query if it is done, or after waiting for it
+	void readQuery(int queryFrame, int slot, bool wait);
+
+	// member variables
+	History histories[SECTION_COUNT];
+	bool gpuTiming;
+	GLuint queries[QUERY_FRAMES][GPU_SECTIONS];
+
+	// frame number each query was issued in, negative once its result is taken
+	int issued[QUERY_FRAMES][GPU_SECTIONS];
+	int frame, frameNumber;
+
+	bool logging;
+	std::vector<float> frameLog[GPU_SECTIONS];
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,77 @@
+#include "renderqueue.h"
+#include "glstate.h"
+
+#include <cstring>
+
+void RenderQueue::clear()
+{
+	packets.clear();
+	entries.clear();
+}
+
+void RenderQueue::submit(const DrawPacket& packet, GLuint texture, GLuint mesh, float depth)
+{
+	entries.push_back({makeKey(packet.program, texture, mesh, depth), uint32_t(packets.size())});
+	packets.push_back(packet);
+}
+
+void RenderQueue::execute()
+{
+	sort();
+
+	// program changes are rare, the state cache skips repeated ones
+	for(const Entry& entry : entries) {
+		const DrawPacket& packet = packets[entry.packet];
+		GLState::useProgram(packet.program);
+		packet.object->draw(packet);
+	}
+}
+
+size_t RenderQueue::size() const
+{
+	return packets.size();
+}
+
+uint64_t RenderQueue::makeKey(GLuint program, GLuint texture, GLuint mesh, float depth)
+{
+	// the bits of a positive float sort like its value, so the top 24 bits
+	// keep the order of depths without knowing the far plane
+	uint32_t depthBits = 0;
+	if(depth > 0.0f)
+		std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+	// GL names are small, names too large for a field only sort less well
+	return (uint64_t(program & 0xff) << 56)
+		 | (uint64_t(texture & 0xffff) << 40)
+		 | (uint64_t(mesh & 0xffff) << 24)
+		 | uint64_t(depthBits >> 8);
+}
+
+void RenderQueue::sort()
+{
+	scratch.resize(entries.size());
+
+	for(int shift = 0; shift < 64; shift += 8) {
+		// count entries per byte value
+		size_t offsets[256] = {};
+		for(const Entry& entry : entries)
+			offsets[(entry.key >> shift) & 0xff]++;
+
+		// a byte every key shares would not move anything
+		if(offsets[(entries.empty() ? 0 : entries[0].key >> shift) & 0xff] == entries.size())
+			continue;
+
+		// turn counts into start offsets and scatter, keeping the order of equal bytes
+		size_t start = 0;
+		for(size_t& offset : offsets) {
+			size_t count = offset;
+			offset = start;
+			start += count;
+		}
+
+		for(const Entry& entry : entries)
+			scratch[offsets[(entry.key >> shift) & 0xff]++] = entry;
+
+		entries.swap(scratch);
+	}
+}
@@ -0,0 +1,80 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+class Drawable;
+
+// one draw submitted for the current frame
+struct DrawPacket
+{
+	Drawable *object;
+	GLuint program;
+	int lod;
+
+	// offset of the object matrices in the uniform ring, -1 if passed as uniforms
+	GLintptr uniformOffset;
+};
+
+// anything the queue can issue a draw for
+class Drawable
+{
+public:
+	virtual ~Drawable() {}
+	virtual void draw(const DrawPacket& packet) = 0;
+};
+
+// per frame list of draws, sorted so that draws sharing a program, texture
+// and mesh run next to each other and each group is drawn front to back
+class RenderQueue
+{
+public:
+	// forget the draws of the last frame, keeps the allocated memory
+	void clear();
+
+	// add a draw, depth is the distance from the camera
+	void submit(const DrawPacket& packet, GLuint texture, GLuint mesh, float depth);
+
+	// sort the draws by key and issue them in one pass
+	void execute();
+
+	// number of draws submitted this frame
+	size_t size() const;
+
+	// sort key, most significant field first:
+	// program 8 bits, texture 16 bits, mesh 16 bits, depth 24 bits
+	static uint64_t makeKey(GLuint program, GLuint texture, GLuint mesh, float depth);
+
+private:
+	// key and packet index, all the sort passes move
+	struct Entry
+	{
+		uint64_t key;
+		uint32_t packet;
+	};
+
+	// LSD radix sort of the entries, one pass per key byte that differs
+	void sort();
+
+	// member variables, scratch is the second buffer of the sort
+	std::vector<DrawPacket> packets;
+	std::vector<Entry> entries, scratch;
+};
+
+#endif // RENDER_QUEUE_H
@@ -10,7 +10,7 @@ ShaderLoader::ShaderLoader(const ShaderLoader& other) : shader(other.shader),
 {
 }
 
-bool ShaderLoader::load(std::string filename)
+bool ShaderLoader::load(std::string filename, const std::string& header)
 {
     // init variables
     std::ifstream fin(filename);
@@ -29,13 +29,14 @@ bool ShaderLoader::load(std::string filename)
     fin.seekg(0, std::ios::beg);
 
     // allocate proper space for file content
-    shaderContent.reserve(length);
+    shaderContent.reserve(header.size() + length);
+    shaderContent = header;
 
     // fill string with contents of file
 	// solution found at stackoverflow.com from user Tyler McHenry
     auto fileIterator = std::istreambuf_iterator<char>(fin);
     auto iteratorEnd = std::istreambuf_iterator<char>();
-    shaderContent.assign(fileIterator, iteratorEnd);
+    shaderContent.append(fileIterator, iteratorEnd);
 
     // close input file
     fin.close();
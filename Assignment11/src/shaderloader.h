@@ -29,8 +29,8 @@ public:
     ~ShaderLoader() {}
     ShaderLoader(const ShaderLoader& other);
     
-    // load shader file
-    bool load(std::string filename);
+    // load shader file, header is put in front of the source (version and defines)
+    bool load(std::string filename, const std::string& header = "");
     
     // get shader ID
     GLuint getShader() const;
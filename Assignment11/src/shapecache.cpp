@@ -0,0 +1,101 @@
+#include "shapecache.h"
+#include "meshcache.h"
+#include "hullcache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+btCollisionShape* ShapeCache::read(const std::string& modelFile, bool hulls,
+	btBulletWorldImporter*& importer)
+{
+	std::string name = shapeName(modelFile, hulls);
+	if(name.empty())
+		return nullptr;
+
+	std::ifstream fin(cacheName(modelFile), std::ios::binary | std::ios::ate);
+	if(!fin)
+		return nullptr;
+
+	// bullet parses the file in place, so read it into a writable buffer
+	std::vector<char> buffer(size_t(fin.tellg()));
+	fin.seekg(0);
+	fin.read(buffer.data(), buffer.size());
+	if(!fin)
+		return nullptr;
+
+	// only a shape stored under the current name matches the model
+	btBulletWorldImporter *loaded = new btBulletWorldImporter();
+	btCollisionShape *shape = nullptr;
+	if(loaded->loadFileFromMemory(buffer.data(), int(buffer.size())))
+		shape = loaded->getCollisionShapeByName(name.c_str());
+
+	if(!shape) {
+		loaded->deleteAllData();
+		delete loaded;
+		return nullptr;
+	}
+
+	importer = loaded;
+	return shape;
+}
+
+bool ShapeCache::write(const std::string& modelFile, bool hulls, const btCollisionShape *shape)
+{
+	std::string name = shapeName(modelFile, hulls);
+	if(name.empty())
+		return false;
+
+	// serialize the shape with its children, mesh and bvh under the current name
+	btDefaultSerializer serializer;
+	serializer.startSerialization();
+	serializer.registerNameForPointer(shape, name.c_str());
+	shape->serializeSingleShape(&serializer);
+	serializer.finishSerialization();
+
+	// write to a temporary file and rename so readers never see a partial cache
+	std::string tempName = cacheName(modelFile) + ".tmp";
+	std::ofstream fout(tempName, std::ios::binary | std::ios::trunc);
+	if(!fout) {
+		std::cerr << "Unable to write shape cache: " << cacheName(modelFile) << std::endl;
+		return false;
+	}
+
+	fout.write(reinterpret_cast<const char*>(serializer.getBufferPointer()), serializer.getCurrentBufferSize());
+	fout.close();
+
+	if(!fout || std::rename(tempName.c_str(), cacheName(modelFile).c_str()) != 0) {
+		std::cerr << "Unable to write shape cache: " << cacheName(modelFile) << std::endl;
+		std::remove(tempName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::string ShapeCache::cacheName(const std::string& modelFile)
+{
+	return modelFile + ".bullet";
+}
+
+std::string ShapeCache::shapeName(const std::string& modelFile, bool hulls)
+{
+	uint64_t time, size, hash;
+	if(!MeshCache::sourceKey(modelFile, time, size, hash))
+		return std::string();
+
+	std::ostringstream name;
+	name << modelFile << (hulls ? " hulls " : " triangles ") << VERSION
+		 << " " << time << " " << size << " " << std::hex << hash;
+
+	// hulls also change when the decomposition tool rewrites the hull cache
+	if(hulls) {
+		if(!MeshCache::sourceKey(HullCache::cacheName(modelFile), time, size, hash))
+			return std::string();
+		name << " " << std::dec << time << " " << size << " " << std::hex << hash;
+	}
+
+	return name.str();
+}
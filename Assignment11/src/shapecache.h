@@ -0,0 +1,44 @@
+#ifndef SHAPE_CACHE_H
+#define SHAPE_CACHE_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletWorldImporter/btBulletWorldImporter.h>
+
+#include <string>
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// fully built collision shape of a model written with bullet's serializer,
+// stored next to the model file as a regular .bullet file
+class ShapeCache
+{
+public:
+	// load the shape of a model if the cache matches the model and shape type,
+	// the returned importer owns the shape and its mesh data
+	static btCollisionShape* read(const std::string& modelFile, bool hulls,
+		btBulletWorldImporter*& importer);
+
+	// write the shape of a model
+	static bool write(const std::string& modelFile, bool hulls, const btCollisionShape *shape);
+
+	// name of the cache file belonging to a model
+	static std::string cacheName(const std::string& modelFile);
+
+	static const int VERSION = 1;
+
+private:
+	// name the shape is stored under, changes with the model file and shape type
+	static std::string shapeName(const std::string& modelFile, bool hulls);
+};
+
+#endif // SHAPE_CACHE_H
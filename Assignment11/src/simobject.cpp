@@ -1,23 +1,25 @@
 #include "simobject.h"
 #include "engine.h"
+#include "assetregistry.h"
 
-// constructor
-SimObject::SimObject(GLuint program, btScalar mass, std::string modelFile, btVector3 vec)
-    : ml(modelFile.c_str())
-{
-	// load geometry from model file
-	auto geo = ml.load(triangleCount, textureCount, lighting);
-	Vertex *geometry = new Vertex[geo.size()];
-	for(unsigned int i = 0; i < geo.size(); i++)
-		geometry[i] = geo[i];
+#include <algorithm>
+#include <cmath>
 
-    // Create a Vertex Buffer object to store this vertex info on the GPU
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(*geometry) * geo.size(), geometry, GL_STATIC_DRAW);
+ObjectUniforms ObjectUniforms::fromModel(const glm::mat4& model)
+{
+	// normals go through the inverse transpose to stay perpendicular to the surface,
+	// which for a rotation is the rotation itself
+	return ObjectUniforms{Engine::getViewProjection() * model,
+		glm::mat4(Engine::getNormalViewProjection() * glm::mat3(model))};
+}
 
+// constructor
+SimObject::SimObject(GLuint program, std::string modelFile, glm::mat4 model)
+    : program(program), asset(AssetRegistry::acquireMesh(modelFile)), model(model), visible(true)
+{
     // get all attribute locations from OpenGL program
 	loc_mvp = glGetUniformLocation(program, "mvpMatrix");
+	loc_normalMatrix = glGetUniformLocation(program, "normalMatrix");
 	loc_position = glGetAttribLocation(program, "v_position");
 	loc_texture = glGetUniformLocation(program,"tex");
 	loc_texCoord = glGetAttribLocation(program,"v_texCoord");
@@ -26,11 +28,13 @@ SimObject::SimObject(GLuint program, btScalar mass, std::string modelFile, btVec
 	loc_normals = glGetAttribLocation(program, "v_normal");
 
 	// if any location not found, throw an error
-	if(loc_mvp == -1 || loc_position == -1 ||
+	bool matrixUniforms = !Engine::getUniformRing();
+	if((matrixUniforms && (loc_mvp == -1 || loc_normalMatrix == -1)) || loc_position == -1 ||
 		loc_texture == -1 || loc_texCoord == -1
 		    || loc_hasTexture == -1 || loc_color == -1
 		        || loc_normals == -1) {
                     std::cerr << loc_mvp << "\n"
+                              << loc_normalMatrix << "\n"
                               << loc_position << "\n"
                               << loc_texture << "\n"
                               << loc_texCoord << "\n"
@@ -40,94 +44,33 @@ SimObject::SimObject(GLuint program, btScalar mass, std::string modelFile, btVec
 	                throw std::runtime_error("Unable to get locations in SimObject::SimObject()");
 		}
 
-	// initialize physics mesh
-	btTriangleMesh *mesh = new btTriangleMesh();
-	for(unsigned int i = 0; i < geo.size(); i+=3) {
-		mesh->addTriangle(btVector3(geometry[i].position[0], geometry[i].position[1], geometry[i].position[2]),
-						  btVector3(geometry[i+1].position[0], geometry[i+1].position[1], geometry[i+1].position[2]),
-						  btVector3(geometry[i+2].position[0], geometry[i+2].position[1], geometry[i+2].position[2]));
-
+	// record the attribute setup once so render only has to bind it,
+	// contexts without vertex array objects set it up on every draw
+	vao = 0;
+	if(GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object) {
+		glGenVertexArrays(1, &vao);
+		GLState::bindVertexArray(vao);
+		setupAttributes();
+		GLState::bindVertexArray(0);
 	}
-
-	// initialize collision shape
-	btGImpactMeshShape * shape = new btGImpactMeshShape(mesh);
-	shape->setLocalScaling(btVector3(1.0,1.0,1.0));
-	shape->updateBound();
-
-	btDefaultMotionState* fallMotionState = new btDefaultMotionState(btTransform(btQuaternion(0,0,0,1), vec));
-	btVector3 fallInertia(0,0,0);
-	if(mass > 0) {
-		shape->calculateLocalInertia(mass, fallInertia);
-	}
-	shape->calculateLocalInertia(mass, fallInertia);
-	btRigidBody::btRigidBodyConstructionInfo shape1CI(mass,fallMotionState,shape,fallInertia);
-	shape1CI.m_friction = 0.5;
-	//shape1CI.m_restitution = 0.0;
-
-	// create rigid body from collision shape
-	meshBody = new btRigidBody(shape1CI);
-
-	// disable object from deactivating
-	meshBody->setActivationState(DISABLE_DEACTIVATION);
 }
 
 // destructor
 SimObject::~SimObject()
 {
+	if(vao)
+		GLState::deleteVertexArray(vao);
 }
 
-void SimObject::update()
-{
-    float m[16];
-    btTransform trans;
-    glm::mat4 glMat;
-
-    // get objects position in the world
-    meshBody->getMotionState()->getWorldTransform(trans);
-
-    // get openGL matrix from world
-	trans.getOpenGLMatrix(m);
-
-	// load OpenGL matrix into glm matrix
-	int k = 0;
-	for(int i = 0; i < 4; i++)
-		for(int j = 0; j < 4; j++) {
-			glMat[i][j] = m[k++];
-		}
-
-	// update model matrix
-	model = glMat;
-
-	// get position and test if score needs to be updated
-	auto pos = getPosition();
-	if(pos.y() < -15) {
-		Engine::score(0);
-		reset();
-	}
-	// win position is around -9x and-6.5z
-	pos = getPosition();
-	if(pos.x() < -9 && (pos.z() <= -6.3 && pos.z() >= -6.7)) {
-		Engine::score(1);
-		reset();
-	}
-		
-}
-
-void SimObject::render(bool ambient, bool specular, bool diffuse)
+void SimObject::setupAttributes() const
 {
-	// calculate MVP matrix
-	glm::mat4 mvp = Engine::getProjection() * Engine::getView() * model;
-
-	// pass MVP to OpenGL program
-	glUniformMatrix4fv(loc_mvp, 1, GL_FALSE, glm::value_ptr(mvp));
-
     //set up the Vertex Buffer Object so it can be drawn
     glEnableVertexAttribArray(loc_position);
     glEnableVertexAttribArray(loc_texCoord);
     glEnableVertexAttribArray(loc_color);
     glEnableVertexAttribArray(loc_normals);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, asset->getVBO());
 
     //set pointers into the vbo for each of the attributes
     glVertexAttribPointer( loc_position,
@@ -158,75 +101,136 @@ void SimObject::render(bool ambient, bool specular, bool diffuse)
     					   sizeof(Vertex),
     					   (void*)offsetof(Vertex,color));
 
+    // indices are part of the attribute setup as well
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, asset->getIBO());
+}
+
+int SimObject::selectLod() const
+{
+	int lodCount = asset->getLodCount();
+	if(lodCount <= 1)
+		return 0;
+
+	// project the bounding sphere to get its size on screen in pixels
+	const GLfloat *center = asset->getBoundsCenter();
+	glm::vec4 viewCenter = Engine::getView() * model * glm::vec4(center[0], center[1], center[2], 1.0f);
+	float distance = std::max(-viewCenter.z, 0.01f);
+	float pixels = asset->getBoundsRadius() * Engine::getProjection()[1][1]
+		* Engine::getHeight() * 0.5f / distance;
+
+	// full detail above the threshold, then one level less each time the size halves
+	if(pixels >= LOD_FULL_DETAIL_PIXELS)
+		return 0;
+	int level = int(std::log2(LOD_FULL_DETAIL_PIXELS / std::max(pixels, 1.0f)));
+	return std::min(level, lodCount - 1);
+}
+
+void SimObject::submit(RenderQueue& queue)
+{
+	// calculate matrices once per frame, the clip w of the origin is the depth to sort by
+	uniforms = ObjectUniforms::fromModel(model);
+	float depth = uniforms.mvp[3][3];
+	DrawPacket packet = {this, program, selectLod(), -1};
+
+	// write the matrices into this frame's part of the uniform ring
+	if(UniformRing *ring = Engine::getUniformRing()) {
+		packet.uniformOffset = ring->push(&uniforms, sizeof(uniforms));
+	}
+
+	// sort by the first texture and the vertex buffer of the shared asset
+	GLuint texture = asset->getTextureCount() > 0 ? asset->getTexture(0) : 0;
+	queue.submit(packet, texture, asset->getVBO(), depth);
+}
+
+void SimObject::draw(const DrawPacket& packet)
+{
+	// point the matrix block at this object or pass the matrices to OpenGL program
+	if(packet.uniformOffset >= 0) {
+		Engine::getUniformRing()->bind(ObjectUniforms::BINDING, packet.uniformOffset, sizeof(ObjectUniforms));
+	}
+	else {
+		GLState::uniformMatrix4fv(loc_mvp, glm::value_ptr(uniforms.mvp));
+		GLState::uniformMatrix4fv(loc_normalMatrix, glm::value_ptr(uniforms.normalMatrix));
+	}
+
+    // bind recorded attribute setup or set it up directly
+    if(vao)
+        GLState::bindVertexArray(vao);
+    else
+        setupAttributes();
+
     // if textureCount > 0, hasTexture flag set to true, otherwise false
-    glUniform1i(loc_hasTexture, textureCount);
+    int textureCount = asset->getTextureCount();
+    GLState::uniform1i(loc_hasTexture, textureCount);
 
     // send texture locations for all textures
 	for(int i = 0; i < textureCount; i++) {
-		glUniform1i(loc_texture,i);
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D,ml.getTexture(i));
-		glUniform1i(loc_texture,i);
+		GLState::uniform1i(loc_texture,i);
+		GLState::activeTexture(GL_TEXTURE0 + i);
+		GLState::bindTexture(GL_TEXTURE_2D,asset->getTexture(i));
+		GLState::uniform1i(loc_texture,i);
 	}
 
-	// draw object
-    glDrawArrays(GL_TRIANGLES, 0, triangleCount*3);//mode, starting index, count
+	// draw object, indexed if an index buffer exists
+	if(asset->getIBO()) {
+		const MeshLod& lod = asset->getLod(packet.lod);
+		glDrawElements(GL_TRIANGLES, lod.indexCount, asset->getIndexType(),
+			(void*)(size_t(lod.firstIndex) * asset->getIndexSize()));
+	}
 
-    // disable attribute pointers
-	glDisableVertexAttribArray(loc_position);
-    glDisableVertexAttribArray(loc_texCoord);
-    glDisableVertexAttribArray(loc_color);
-    glDisableVertexAttribArray(loc_normals);
-}
+	else {
+		glDrawArrays(GL_TRIANGLES, 0, asset->getTriangleCount()*3);//mode, starting index, count
+	}
 
-void SimObject::move(btVector3 pos)
-{
-	// get transform and update with new position
-    btTransform trans;
-    meshBody->getMotionState()->getWorldTransform(trans);
-    trans.setOrigin(pos);
-
-    // update body with new transform
-    meshBody->getMotionState()->setWorldTransform(trans);
-    meshBody->setCenterOfMassTransform(trans);
+    // unbind attribute setup so later vertex state changes don't touch it
+    if(vao) {
+        GLState::bindVertexArray(0);
+    }
+
+    else {
+        glDisableVertexAttribArray(loc_position);
+        glDisableVertexAttribArray(loc_texCoord);
+        glDisableVertexAttribArray(loc_color);
+        glDisableVertexAttribArray(loc_normals);
+        GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
 }
 
-void SimObject::rotate(float angle, btVector3 y)
+void SimObject::setModel(glm::mat4 newModel)
 {
-	// get transform and update with new rotation
-    btTransform trans;
-    meshBody->getMotionState()->getWorldTransform(trans);
-    trans.setRotation(btQuaternion(y, angle));
-
-    // update body with new transform
-    meshBody->getMotionState()->setWorldTransform(trans);
-    meshBody->setCenterOfMassTransform(trans);
+	model = newModel;
 }
 
-void SimObject::reset()
+const glm::mat4& SimObject::getModel() const
 {
-	// disable all movement
-	meshBody->setLinearVelocity(btVector3(0,0,0));
-	meshBody->setAngularVelocity(btVector3(0,0,0));
-
-	// reset position
-	move(btVector3(0,0.1,0));
+	return model;
 }
 
-btRigidBody* SimObject::getMesh() const
+void SimObject::getWorldBounds(btVector3& low, btVector3& high) const
 {
-	return meshBody;
+	const GLfloat *center = asset->getBoundsCenter();
+	const GLfloat *extents = asset->getBoundsExtents();
+
+	// move the box center and grow the half sizes by the rotated axes
+	glm::vec4 worldCenter = model * glm::vec4(center[0], center[1], center[2], 1.0f);
+	btVector3 worldExtents;
+	for(int i = 0; i < 3; i++) {
+		worldExtents[i] = std::fabs(model[0][i]) * extents[0]
+						+ std::fabs(model[1][i]) * extents[1]
+						+ std::fabs(model[2][i]) * extents[2];
+	}
+
+	btVector3 worldMiddle(worldCenter.x, worldCenter.y, worldCenter.z);
+	low = worldMiddle - worldExtents;
+	high = worldMiddle + worldExtents;
 }
 
-void SimObject::setModel(glm::mat4 newModel)
+bool SimObject::isVisible() const
 {
-	model = newModel;
+	return visible;
 }
 
-btVector3 SimObject::getPosition() const
+void SimObject::setVisible(bool inside)
 {
-	// get transform and return position from it
-	btTransform trans;
-	meshBody->getMotionState()->getWorldTransform(trans);
-	return trans.getOrigin();
+	visible = inside;
 }
@@ -12,43 +12,68 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 
 #include <btBulletDynamicsCommon.h>
 #include <BulletCollision/Gimpact/btGImpactShape.h>
 
 #include <string>
 #include <stdexcept>
+#include <memory>
 
 #include "vertex.h"
-#include "modelloader.h"
+#include "meshasset.h"
+#include "glstate.h"
+#include "renderqueue.h"
+#include "uniformring.h"
 
 // re-enable warnings
 #ifdef __APPLE__
 #pragma clang diagnostic pop
 #endif
 
-class SimObject
+// matrices of one draw, laid out like the std140 ObjectMatrices block in vert.vs
+struct ObjectUniforms
+{
+	glm::mat4 mvp;
+	glm::mat4 normalMatrix;
+
+	// fill both from this frame's camera and a rigid model matrix, the normal matrix is the
+	// engine's per frame inverse transpose of the camera times the model rotation, no inverse per object
+	static ObjectUniforms fromModel(const glm::mat4& model);
+
+	// binding point of the ObjectMatrices block
+	static const GLuint BINDING = 0;
+};
+
+// drawn side of an object, its rigid body is a PhysicsBody of the Labyrinth
+// and the model matrix comes from the simulation through snapshots
+class SimObject : public Drawable
 {
 public:
 	// constructor and destructor
-	SimObject(GLuint program = 0, btScalar mass = 1, std::string modelFile = "cube.obj", btVector3 vec = btVector3(0,0,0));
+	SimObject(GLuint program = 0, std::string modelFile = "cube.obj", glm::mat4 model = glm::mat4(1.0f));
 	virtual ~SimObject();
 
-	// functions to update the object
-	virtual void update();
-	virtual void render(bool ambient, bool specular, bool diffuse);
-	void move(btVector3 pos = btVector3(0,0,0));
-	void rotate(float angle, btVector3 y = btVector3(0,1,0));
-	virtual void reset();
+	// functions to draw the object
+	virtual void submit(RenderQueue& queue);
+	virtual void draw(const DrawPacket& packet);
 
 	// getter and setter functions
-	virtual btRigidBody* getMesh() const;
 	virtual void setModel(glm::mat4 newModel);
-	virtual btVector3 getPosition() const;
+	const glm::mat4& getModel() const;
+
+	// bounding box of the model in world space
+	void getWorldBounds(btVector3& low, btVector3& high) const;
+
+	// set by frustum culling each frame
+	bool isVisible() const;
+	void setVisible(bool inside);
 
 protected:
-	// OpenGL variable locations
+	// OpenGL variable locations, matrices have none when they come from the uniform ring
 	GLint loc_mvp;
+	GLint loc_normalMatrix;
 	GLint loc_position;
 	GLint loc_texture;
 	GLint loc_texCoord;
@@ -56,15 +81,25 @@ protected:
 	GLint loc_color;
 	GLint loc_normals;
 
-	// member variables
-	GLuint vbo;
-	int triangleCount, textureCount;
-    bool hasTexture;
-	glm::mat4 model;
-	ModelLoader ml;
-	Vertex lighting;
+	// projected size in pixels below which lower detail levels are drawn
+	static constexpr float LOD_FULL_DETAIL_PIXELS = 256.0f;
+
+	// pick a detail level from the on-screen size of the bounding sphere
+	int selectLod() const;
 
-	btRigidBody *meshBody;
+	// enable and point every attribute into the vertex buffer of the asset
+	void setupAttributes() const;
+
+	// instance batches set up their vertex arrays like the objects they draw
+	friend class InstanceBatch;
+
+	// member variables, the asset is shared with every object of the same model
+	GLuint program;
+	std::shared_ptr<MeshAsset> asset;
+	glm::mat4 model;
+	ObjectUniforms uniforms;
+	GLuint vao;
+	bool visible;
 };
 
 #endif // SIM_OBJECT_H
@@ -0,0 +1,27 @@
+#include "snapshotbuffer.h"
+
+// constructor
+SnapshotBuffer::SnapshotBuffer()
+	: writing(0), reading(1), shared(2)
+{
+}
+
+Snapshot& SnapshotBuffer::write()
+{
+	return snapshots[writing];
+}
+
+void SnapshotBuffer::publish()
+{
+	// trade the written snapshot for the shared one, which the reader is done with
+	writing = shared.exchange(writing | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+const Snapshot& SnapshotBuffer::read()
+{
+	// only trade when the simulation published something new
+	if(shared.load(std::memory_order_relaxed) & FRESH)
+		reading = shared.exchange(reading, std::memory_order_acq_rel) & ~FRESH;
+
+	return snapshots[reading];
+}
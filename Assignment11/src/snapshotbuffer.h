@@ -0,0 +1,66 @@
+#ifndef SNAPSHOT_BUFFER_H
+#define SNAPSHOT_BUFFER_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// everything rendering needs from one simulation step
+struct Snapshot
+{
+	// model matrices of the objects followed by the extra balls
+	std::vector<glm::mat4> transforms;
+
+	// HUD state
+	float gameTime;
+	int gameScore;
+	std::vector<std::string> topTenScores;
+
+	// steps taken so far and the milliseconds parts of the latest steps took
+	unsigned long step = 0;
+	float inputTime = 0.0f, physicsTime = 0.0f, objectTime = 0.0f;
+};
+
+// hands the newest snapshot from the simulation thread to the render thread
+// without locks, a third snapshot lets both sides work while one is swapped
+class SnapshotBuffer
+{
+public:
+	// constructor
+	SnapshotBuffer();
+	SnapshotBuffer(const SnapshotBuffer& other) = delete;
+
+	// snapshot the simulation fills next
+	Snapshot& write();
+
+	// make the written snapshot the newest one
+	void publish();
+
+	// newest published snapshot, stays valid until the next call
+	const Snapshot& read();
+
+private:
+	// set on the shared index while it holds a snapshot the reader hasn't seen
+	static const int FRESH = 4;
+
+	// member variables, each side owns one snapshot and the third is shared
+	Snapshot snapshots[3];
+	int writing, reading;
+	std::atomic<int> shared;
+};
+
+#endif // SNAPSHOT_BUFFER_H
@@ -0,0 +1,293 @@
+#include "textrenderer.h"
+
+#include <iostream>
+#include <stdexcept>
+
+// anchor in screen coordinates, pixel offset, atlas coordinates and color
+static const int FLOATS_PER_VERTEX = 9;
+
+// pixels kept around every glyph since bitmaps may start left of their origin
+static const int PAD = 1;
+
+// constructor
+TextRenderer::TextRenderer(GLuint program, void *font)
+	: layoutChanged(true), program(program), atlas(0), vbo(0), vao(0), vertexCount(0), bufferSize(0)
+{
+	// get all locations from OpenGL program
+	loc_position = glGetAttribLocation(program, "v_position");
+	loc_texCoord = glGetAttribLocation(program, "v_texCoord");
+	loc_color = glGetAttribLocation(program, "v_color");
+	loc_atlas = glGetUniformLocation(program, "atlas");
+	loc_screenSize = glGetUniformLocation(program, "screenSize");
+
+	// if any location not found, throw an error
+	if(loc_position == -1 || loc_texCoord == -1 || loc_color == -1
+			|| loc_atlas == -1 || loc_screenSize == -1) {
+		std::cerr << loc_position << "\n"
+				  << loc_texCoord << "\n"
+				  << loc_color << "\n"
+				  << loc_atlas << "\n"
+				  << loc_screenSize << std::endl;
+		throw std::runtime_error("Unable to get locations in TextRenderer::TextRenderer()");
+	}
+
+	buildAtlas(font);
+	glGenBuffers(1, &vbo);
+
+	// record the attribute setup once so render only has to bind it,
+	// contexts without vertex array objects set it up on every draw
+	if(GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object) {
+		glGenVertexArrays(1, &vao);
+		GLState::bindVertexArray(vao);
+		GLState::bindBuffer(GL_ARRAY_BUFFER, vbo);
+		setupAttributes();
+		GLState::bindVertexArray(0);
+	}
+}
+
+// destructor
+TextRenderer::~TextRenderer()
+{
+	if(vao)
+		GLState::deleteVertexArray(vao);
+	GLState::deleteBuffer(vbo);
+	GLState::deleteTexture(atlas);
+}
+
+void TextRenderer::setupAttributes() const
+{
+	//set pointers into the vbo for each of the attributes
+	glEnableVertexAttribArray(loc_position);
+	glEnableVertexAttribArray(loc_texCoord);
+	glEnableVertexAttribArray(loc_color);
+
+	GLsizei stride = sizeof(GLfloat) * FLOATS_PER_VERTEX;
+	glVertexAttribPointer(loc_position, 4, GL_FLOAT, GL_FALSE, stride, (void*)0);
+	glVertexAttribPointer(loc_texCoord, 2, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * 4));
+	glVertexAttribPointer(loc_color, 3, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * 6));
+}
+
+void TextRenderer::setText(int slot, const char *text, glm::vec2 pos, glm::vec3 color)
+{
+	if(slot >= int(slots.size())) {
+		slots.resize(slot + 1);
+		layoutChanged = true;
+	}
+
+	// nothing to do for text that is already on screen
+	Slot& current = slots[slot];
+	if(current.text == text && current.pos == pos && current.color == color)
+		return;
+
+	current.text = text;
+	current.pos = pos;
+	current.color = color;
+
+	// same number of vertices can be replaced in place, otherwise everything moves
+	size_t oldSize = current.vertices.size();
+	buildVertices(current);
+	if(current.vertices.size() == oldSize)
+		current.changed = true;
+	else
+		layoutChanged = true;
+}
+
+void TextRenderer::truncate(int slotCount)
+{
+	if(slotCount < int(slots.size())) {
+		slots.resize(slotCount);
+		layoutChanged = true;
+	}
+}
+
+void TextRenderer::render(int width, int height)
+{
+	GLState::bindBuffer(GL_ARRAY_BUFFER, vbo);
+
+	// upload all slots after a length change, otherwise only the changed ones
+	if(layoutChanged) {
+		vertices.clear();
+		for(Slot& slot : slots) {
+			vertices.insert(vertices.end(), slot.vertices.begin(), slot.vertices.end());
+			slot.changed = false;
+		}
+
+		vertexCount = vertices.size() / FLOATS_PER_VERTEX;
+		if(GLsizei(vertices.size()) > bufferSize) {
+			bufferSize = vertices.size();
+			glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * bufferSize, vertices.data(), GL_DYNAMIC_DRAW);
+		}
+		else {
+			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * vertices.size(), vertices.data());
+		}
+
+		layoutChanged = false;
+	}
+
+	else {
+		size_t offset = 0;
+		for(Slot& slot : slots) {
+			if(slot.changed) {
+				glBufferSubData(GL_ARRAY_BUFFER, sizeof(GLfloat) * offset,
+					sizeof(GLfloat) * slot.vertices.size(), slot.vertices.data());
+				slot.changed = false;
+			}
+			offset += slot.vertices.size();
+		}
+	}
+
+	if(vertexCount == 0)
+		return;
+
+	// text goes on top of the scene and blends with it
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	GLState::useProgram(program);
+	GLState::uniform2f(loc_screenSize, float(width), float(height));
+	GLState::uniform1i(loc_atlas, 0);
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_2D, atlas);
+
+	// bind recorded attribute setup or set it up directly
+	if(vao)
+		GLState::bindVertexArray(vao);
+	else
+		setupAttributes();
+
+	// draw all text at once
+	glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+
+	// unbind attribute setup so later vertex state changes don't touch it
+	if(vao) {
+		GLState::bindVertexArray(0);
+	}
+
+	else {
+		glDisableVertexAttribArray(loc_position);
+		glDisableVertexAttribArray(loc_texCoord);
+		glDisableVertexAttribArray(loc_color);
+	}
+
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+}
+
+bool TextRenderer::supported()
+{
+	// the atlas is drawn with window positions into a framebuffer object
+	return (GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object) && GLEW_VERSION_1_4;
+}
+
+void TextRenderer::buildAtlas(void *font)
+{
+	const int atlasWidth = 512, rowHeight = DESCENT + ASCENT + 2*PAD;
+
+	// lay out the characters in rows, keeping a gap around each
+	std::vector<glm::ivec2> cells;
+	glm::ivec2 cell(PAD, PAD);
+	for(int c = FIRST_CHAR; c <= LAST_CHAR; c++) {
+		int width = glutBitmapWidth(font, c);
+		if(cell.x + width + PAD > atlasWidth) {
+			cell.x = PAD;
+			cell.y += rowHeight;
+		}
+
+		cells.push_back(cell);
+		glyphs.push_back(Glyph{0, 0, 0, 0, width});
+		cell.x += width + 2*PAD;
+	}
+
+	int atlasHeight = 1;
+	while(atlasHeight < cell.y + rowHeight)
+		atlasHeight *= 2;
+
+	// empty texture the glyphs are drawn into
+	glGenTextures(1, &atlas);
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_2D, atlas);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlasWidth, atlasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// render into the texture through a temporary framebuffer
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	GLuint framebuffer;
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, atlas, 0);
+
+	if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &framebuffer);
+		throw std::runtime_error("Unable to render glyphs in TextRenderer::buildAtlas()");
+	}
+
+	glViewport(0, 0, atlasWidth, atlasHeight);
+	glClearColor(0.0, 0.0, 0.0, 0.0);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	// white glyphs with fixed function bitmaps, untextured so the atlas doesn't read itself
+	GLState::useProgram(0);
+	glDisable(GL_TEXTURE_2D);
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+	for(int c = FIRST_CHAR; c <= LAST_CHAR; c++) {
+		const glm::ivec2& origin = cells[c - FIRST_CHAR];
+		glWindowPos2i(origin.x, origin.y + DESCENT);
+		glutBitmapCharacter(font, c);
+	}
+	glEnable(GL_TEXTURE_2D);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDeleteFramebuffers(1, &framebuffer);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+	// atlas coordinates including the gap
+	for(size_t i = 0; i < glyphs.size(); i++) {
+		glyphs[i].u0 = GLfloat(cells[i].x - PAD) / atlasWidth;
+		glyphs[i].v0 = GLfloat(cells[i].y - PAD) / atlasHeight;
+		glyphs[i].u1 = GLfloat(cells[i].x + glyphs[i].width + PAD) / atlasWidth;
+		glyphs[i].v1 = GLfloat(cells[i].y + DESCENT + ASCENT + PAD) / atlasHeight;
+	}
+}
+
+void TextRenderer::buildVertices(Slot& slot) const
+{
+	slot.vertices.clear();
+
+	int penX = 0;
+	for(unsigned char c : slot.text) {
+		// characters outside the atlas are drawn as spaces
+		if(c < FIRST_CHAR || c > LAST_CHAR)
+			c = ' ';
+
+		const Glyph& glyph = glyphs[c - FIRST_CHAR];
+
+		// spaces only move the pen
+		if(c != ' ') {
+			GLfloat left = penX - PAD, right = penX + glyph.width + PAD;
+			GLfloat bottom = -DESCENT - PAD, top = ASCENT + PAD;
+
+			// two triangles, corners as offset and atlas coordinate pairs
+			const GLfloat corners[6][4] = {
+				{left, bottom, glyph.u0, glyph.v0}, {right, bottom, glyph.u1, glyph.v0}, {right, top, glyph.u1, glyph.v1},
+				{left, bottom, glyph.u0, glyph.v0}, {right, top, glyph.u1, glyph.v1}, {left, top, glyph.u0, glyph.v1}
+			};
+
+			for(const GLfloat *corner : corners) {
+				const GLfloat vertex[FLOATS_PER_VERTEX] = {
+					slot.pos.x, slot.pos.y, corner[0], corner[1], corner[2], corner[3],
+					slot.color.r, slot.color.g, slot.color.b
+				};
+				slot.vertices.insert(slot.vertices.end(), vertex, vertex + FLOATS_PER_VERTEX);
+			}
+		}
+
+		penX += glyph.width;
+	}
+}
@@ -0,0 +1,99 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+#ifndef __APPLE__
+#include <GL/freeglut.h>
+
+#else
+#include <GL/glut.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+#include "glstate.h"
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// draws all HUD text from one glyph atlas with a single draw call,
+// text is kept in numbered slots and only rebuilt when it changes
+class TextRenderer
+{
+public:
+	// constructor and destructor, builds the atlas from a GLUT bitmap font
+	TextRenderer(GLuint program, void *font = GLUT_BITMAP_HELVETICA_18);
+	~TextRenderer();
+	TextRenderer(const TextRenderer& other) = delete;
+
+	// set the text of a slot, pos is the start of the baseline in screen coordinates
+	void setText(int slot, const char *text, glm::vec2 pos, glm::vec3 color);
+
+	// drop slots from this one on, for text that is no longer shown
+	void truncate(int slotCount);
+
+	// draw every slot, width and height are the window size in pixels
+	void render(int width, int height);
+
+	// true if the context can render the atlas into a texture
+	static bool supported();
+
+private:
+	// atlas position and advance of one character
+	struct Glyph
+	{
+		GLfloat u0, v0, u1, v1;
+		int width;
+	};
+
+	// one piece of text and its part of the vertex buffer
+	struct Slot
+	{
+		std::string text;
+		glm::vec2 pos;
+		glm::vec3 color;
+		std::vector<GLfloat> vertices;
+		bool changed;
+	};
+
+	// draw the font into the atlas texture
+	void buildAtlas(void *font);
+
+	// make the quads of a slot from its text
+	void buildVertices(Slot& slot) const;
+
+	// enable the attributes and point them into the vertex buffer
+	void setupAttributes() const;
+
+	// first and last printable character in the atlas
+	static const int FIRST_CHAR = 32, LAST_CHAR = 126;
+
+	// pixel rows below and above the baseline in the atlas
+	static const int DESCENT = 6, ASCENT = 18;
+
+	// member variables
+	std::vector<Glyph> glyphs;
+	std::vector<Slot> slots;
+	std::vector<GLfloat> vertices;
+	bool layoutChanged;
+	GLuint program, atlas, vbo, vao;
+	GLsizei vertexCount, bufferSize;
+
+	// OpenGL variable locations
+	GLint loc_position, loc_texCoord, loc_color;
+	GLint loc_atlas, loc_screenSize;
+};
+
+#endif // TEXT_RENDERER_H
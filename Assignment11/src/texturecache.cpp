@@ -0,0 +1,149 @@
+#include "texturecache.h"
+#include "meshcache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+unsigned int TextureImage::levelWidth(unsigned int level) const
+{
+	return width >> level ? width >> level : 1;
+}
+
+unsigned int TextureImage::levelHeight(unsigned int level) const
+{
+	return height >> level ? height >> level : 1;
+}
+
+size_t TextureImage::levelOffset(unsigned int level) const
+{
+	size_t offset = 0;
+	for(unsigned int i = 0; i < level; i++)
+		offset += size_t(levelWidth(i)) * levelHeight(i) * 4;
+	return offset;
+}
+
+void TextureImage::buildMipmaps()
+{
+	// count levels down to 1x1
+	levels = 1;
+	while(levelWidth(levels-1) > 1 || levelHeight(levels-1) > 1)
+		levels++;
+
+	pixels.resize(levelOffset(levels));
+
+	for(unsigned int level = 1; level < levels; level++) {
+		const unsigned char *src = pixels.data() + levelOffset(level-1);
+		unsigned char *dst = pixels.data() + levelOffset(level);
+		unsigned int srcWidth = levelWidth(level-1), srcHeight = levelHeight(level-1);
+		unsigned int dstWidth = levelWidth(level), dstHeight = levelHeight(level);
+
+		for(unsigned int y = 0; y < dstHeight; y++) {
+			// clamp the second row and column for odd sizes
+			unsigned int y0 = 2*y, y1 = 2*y+1 < srcHeight ? 2*y+1 : 2*y;
+
+			for(unsigned int x = 0; x < dstWidth; x++) {
+				unsigned int x0 = 2*x, x1 = 2*x+1 < srcWidth ? 2*x+1 : 2*x;
+
+				// average each channel of the 2x2 block, rounded
+				for(unsigned int c = 0; c < 4; c++) {
+					unsigned int sum = src[(y0*srcWidth + x0)*4 + c] + src[(y0*srcWidth + x1)*4 + c]
+									 + src[(y1*srcWidth + x0)*4 + c] + src[(y1*srcWidth + x1)*4 + c];
+					dst[(y*dstWidth + x)*4 + c] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+bool TextureCache::read(const std::string& imageFile, TextureImage& image)
+{
+	TextureCacheHeader header;
+	uint64_t time, size, hash;
+
+	// get key of the current image file
+	if(!MeshCache::sourceKey(imageFile, time, size, hash))
+		return false;
+
+	std::ifstream fin(cacheName(imageFile), std::ios::binary);
+	if(!fin)
+		return false;
+
+	// reject other versions and changed images
+	fin.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if(!fin || std::memcmp(header.magic, "LTEX", 4) != 0 || header.version != VERSION
+		|| header.sourceTime != time || header.sourceSize != size || header.sourceHash != hash)
+		return false;
+
+	// reject sizes no texture can have before allocating for them
+	if(header.width == 0 || header.height == 0 || header.width > MAX_SIZE || header.height > MAX_SIZE
+		|| header.levels == 0 || header.levels > MAX_LEVELS)
+		return false;
+
+	TextureImage cached;
+	cached.width = header.width;
+	cached.height = header.height;
+	cached.levels = header.levels;
+
+	// a truncated or padded file isn't one that write produced
+	size_t pixelSize = cached.levelOffset(cached.levels);
+	std::streamoff pixelStart = fin.tellg();
+	fin.seekg(0, std::ios::end);
+	if(!fin || fin.tellg() - pixelStart != std::streamoff(pixelSize))
+		return false;
+	fin.seekg(pixelStart);
+
+	// read every mip level at once
+	cached.pixels.resize(pixelSize);
+	fin.read(reinterpret_cast<char*>(cached.pixels.data()), cached.pixels.size());
+	if(!fin)
+		return false;
+
+	// only hand out the image once all of it was read
+	image = std::move(cached);
+	return true;
+}
+
+bool TextureCache::write(const std::string& imageFile, const TextureImage& image)
+{
+	TextureCacheHeader header;
+
+	// zero padding so identical images produce identical files
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, "LTEX", 4);
+	header.version = VERSION;
+
+	if(!MeshCache::sourceKey(imageFile, header.sourceTime, header.sourceSize, header.sourceHash))
+		return false;
+
+	header.width = image.width;
+	header.height = image.height;
+	header.levels = image.levels;
+
+	// write to a temporary file and rename so readers never see a partial cache
+	std::string tempName = cacheName(imageFile) + ".tmp";
+	std::ofstream fout(tempName, std::ios::binary | std::ios::trunc);
+	if(!fout) {
+		std::cerr << "Unable to write texture cache: " << cacheName(imageFile) << std::endl;
+		return false;
+	}
+
+	fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	fout.write(reinterpret_cast<const char*>(image.pixels.data()), image.pixels.size());
+	fout.close();
+
+	if(!fout || std::rename(tempName.c_str(), cacheName(imageFile).c_str()) != 0) {
+		std::cerr << "Unable to write texture cache: " << cacheName(imageFile) << std::endl;
+		std::remove(tempName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::string TextureCache::cacheName(const std::string& imageFile)
+{
+	return imageFile + ".tex";
+}
@@ -0,0 +1,59 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// decoded 32 bit BGRA pixels of a texture and its mip chain, ready for upload
+struct TextureImage
+{
+	// size of a mip level and offset of its pixels
+	unsigned int levelWidth(unsigned int level) const;
+	unsigned int levelHeight(unsigned int level) const;
+	size_t levelOffset(unsigned int level) const;
+
+	// fill every level below the first by averaging 2x2 blocks of the level above
+	void buildMipmaps();
+
+	// size of the first level and number of levels in pixels
+	unsigned int width, height;
+	unsigned int levels;
+	std::vector<unsigned char> pixels;
+};
+
+// header at the start of every texture cache file
+struct TextureCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+
+	// key of the image file the cache was built from
+	uint64_t sourceTime, sourceSize, sourceHash;
+
+	// image information
+	uint32_t width, height, levels;
+};
+
+// decoded and mipmapped copy of an image, stored next to the image file
+class TextureCache
+{
+public:
+	// read cache file of an image if it still matches the image
+	static bool read(const std::string& imageFile, TextureImage& image);
+
+	// write cache file for a decoded image
+	static bool write(const std::string& imageFile, const TextureImage& image);
+
+	// name of the cache file belonging to an image
+	static std::string cacheName(const std::string& imageFile);
+
+	static const uint32_t VERSION = 1;
+
+	// largest width or height a cache file may claim, and the levels of its mip chain
+	static const uint32_t MAX_SIZE = 16384;
+	static const uint32_t MAX_LEVELS = 15;
+};
+
+#endif // TEXTURE_CACHE_H
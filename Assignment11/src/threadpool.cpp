@@ -0,0 +1,63 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+	: stopping(false)
+{
+	// hardware_concurrency may not know the core count
+	if(threadCount == 0)
+		threadCount = 1;
+
+	// start workers
+	for(unsigned int i = 0; i < threadCount; i++)
+		workers.push_back(std::thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	// tell workers to stop once the queue is empty
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	available.notify_all();
+
+	// wait for workers
+	for(std::thread& worker : workers)
+		worker.join();
+}
+
+void ThreadPool::enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(task);
+	}
+	available.notify_one();
+}
+
+unsigned int ThreadPool::size() const
+{
+	return workers.size();
+}
+
+void ThreadPool::work()
+{
+	while(true) {
+		std::function<void()> task;
+
+		// wait for a task or for the pool to stop
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+			if(tasks.empty())
+				return;
+
+			task = tasks.front();
+			tasks.pop_front();
+		}
+
+		// run task outside of the lock
+		task();
+	}
+}
@@ -0,0 +1,38 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <deque>
+
+// fixed set of worker threads running queued tasks in order
+class ThreadPool
+{
+public:
+	// constructor and destructor, destructor finishes queued tasks
+	ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+	~ThreadPool();
+	ThreadPool(const ThreadPool& other) = delete;
+
+	// add a task for the next free worker
+	void enqueue(std::function<void()> task);
+
+	// number of worker threads
+	unsigned int size() const;
+
+private:
+	// worker thread loop
+	void work();
+
+	// member variables
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable available;
+	bool stopping;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,90 @@
+#include "uniformring.h"
+#include "glstate.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+// constructor
+UniformRing::UniformRing(GLsizeiptr blockSize, int blocksPerFrame, int frames)
+	: buffer(0), mapped(nullptr), frameSize(0), alignment(256), frames(frames), frame(0), offset(0),
+	  fences(frames, nullptr)
+{
+	// every pushed block has to start on the binding alignment, so sections do too
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	frameSize = (blockSize + alignment - 1) / alignment * alignment * blocksPerFrame;
+
+	// storage stays mapped for the life of the ring, coherent so writes need no flush
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &buffer);
+	GLState::bindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferStorage(GL_UNIFORM_BUFFER, frameSize * frames, nullptr, flags);
+	mapped = static_cast<char*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, frameSize * frames, flags));
+	GLState::bindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	if(!mapped)
+		throw std::runtime_error("Unable to map buffer in UniformRing::UniformRing()");
+
+	offset = frame * frameSize;
+}
+
+// destructor
+UniformRing::~UniformRing()
+{
+	for(GLsync fence : fences)
+		if(fence)
+			glDeleteSync(fence);
+
+	GLState::bindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glUnmapBuffer(GL_UNIFORM_BUFFER);
+	GLState::bindBuffer(GL_UNIFORM_BUFFER, 0);
+	GLState::deleteBuffer(buffer);
+}
+
+void UniformRing::beginFrame()
+{
+	frame = (frame + 1) % frames;
+	offset = frame * frameSize;
+
+	// the section was last read frames ago, so this rarely has to wait
+	GLsync& fence = fences[frame];
+	if(fence) {
+		GLenum status;
+		do {
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		} while(status == GL_TIMEOUT_EXPIRED);
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+}
+
+GLintptr UniformRing::push(const void *data, GLsizeiptr size)
+{
+	GLintptr end = (frame + 1) * frameSize;
+	if(offset + size > end)
+		throw std::runtime_error("Frame section full in UniformRing::push()");
+
+	GLintptr blockOffset = offset;
+	std::memcpy(mapped + blockOffset, data, size);
+	offset += (size + alignment - 1) / alignment * alignment;
+	return blockOffset;
+}
+
+void UniformRing::bind(GLuint index, GLintptr blockOffset, GLsizeiptr size) const
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, blockOffset, size);
+}
+
+void UniformRing::endFrame()
+{
+	fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool UniformRing::supported()
+{
+	bool storage = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+	bool uniformBuffers = GLEW_VERSION_3_1 || GLEW_ARB_uniform_buffer_object;
+	bool sync = GLEW_VERSION_3_2 || GLEW_ARB_sync;
+	return storage && uniformBuffers && sync;
+}
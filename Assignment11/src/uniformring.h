@@ -0,0 +1,56 @@
+#ifndef UNIFORM_RING_H
+#define UNIFORM_RING_H
+
+// disable 3rd party library warnings on Apple
+#ifdef __APPLE__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-W#warnings"
+#pragma clang diagnostic ignored "-Woverloaded-virtual"
+#endif
+
+#include <GL/glew.h>
+
+#include <vector>
+
+// re-enable warnings
+#ifdef __APPLE__
+#pragma clang diagnostic pop
+#endif
+
+// persistently mapped uniform buffer split into one section per frame in
+// flight, a fence keeps the CPU from writing a section the GPU still reads
+class UniformRing
+{
+public:
+	// constructor and destructor, sized for up to blocksPerFrame pushes of blockSize each frame
+	UniformRing(GLsizeiptr blockSize, int blocksPerFrame, int frames = 3);
+	~UniformRing();
+	UniformRing(const UniformRing& other) = delete;
+
+	// move to the next section, waiting until the GPU is done with it
+	void beginFrame();
+
+	// copy a block into the current section, returns its offset in the buffer
+	GLintptr push(const void *data, GLsizeiptr size);
+
+	// bind a pushed block to a uniform block binding point
+	void bind(GLuint index, GLintptr offset, GLsizeiptr size) const;
+
+	// fence the commands reading the current section
+	void endFrame();
+
+	// true if the context has buffer storage, uniform buffers and fences
+	static bool supported();
+
+private:
+	// member variables
+	GLuint buffer;
+	char *mapped;
+	GLsizeiptr frameSize;
+	GLint alignment;
+	int frames, frame;
+	GLintptr offset;
+	std::vector<GLsync> fences;
+};
+
+#endif // UNIFORM_RING_H